@@ -0,0 +1,259 @@
+/**
+ * @file bench_alloc.cpp
+ * @brief Allocation-counting benchmark for the per-search containers.
+ *
+ * Replays the container traffic of an A* search (g-score and parent maps,
+ * open set, neighbor lists, route backtracking) on a synthetic grid, once
+ * with the global heap and once with a per-search Arena, and reports heap
+ * calls, bytes and time per search. One more search per grid size is run
+ * under AllocStats, to split its storage by container: allocations,
+ * reallocations, bytes and peak bytes.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 bench/bench_alloc.cpp src/Cell.cpp src/Arena.cpp \
+ *       src/find_path.cpp src/SurfaceSlab.cpp src/OccupancyGrid.cpp src/Trace.cpp \
+ *       src/AllocStats.cpp -lmcpp -lpthread -o bench_alloc
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "../src/find_path.h"
+#include "../src/AllocStats.h"
+
+
+/* ------------------------------------------
+ * ------ Global allocation counting --------
+ * ------------------------------------------ */
+
+static size_t g_allocCount = 0;
+static size_t g_allocBytes = 0;
+
+void* operator new(size_t bytes) {
+    ++g_allocCount;
+    g_allocBytes += bytes;
+
+    void* p = std::malloc(bytes == 0 ? 1 : bytes);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+
+/* ------------------------------------------
+ * ------------- Workload -------------------
+ * ------------------------------------------ */
+
+/**
+ * @brief Square grid with pseudo-random blocked cells.
+ */
+struct Grid {
+    int size;
+    std::vector<bool> blocked;
+
+    bool isOpen(const mcpp::Coordinate2D& c) const {
+        return c.x >= 0 && c.z >= 0 && c.x < size && c.z < size &&
+               !blocked[c.x * size + c.z];
+    }
+};
+
+Grid makeGrid(int size, int obstaclePercent, unsigned seed) {
+
+    Grid grid{size, std::vector<bool>(size * size, false)};
+
+    unsigned state = seed;
+    for (int i = 0; i < size * size; ++i) {
+        state = state * 1103515245u + 12345u;
+        grid.blocked[i] = int((state >> 16) % 100) < obstaclePercent;
+    }
+
+    // keep the corners open for start and goal
+    grid.blocked[0] = false;
+    grid.blocked[size * size - 1] = false;
+
+    return grid;
+}
+
+/**
+ * @brief Runs one A* search with the given container types.
+ * @return Length of the route found (0 if none).
+ */
+template<typename ScoreM, typename ParentM, typename Open>
+size_t search(const Grid& grid, ScoreM& gScore, ParentM& parent, Open& toExplore) {
+
+    mcpp::Coordinate2D start(0, 0);
+    mcpp::Coordinate2D goal(grid.size - 1, grid.size - 1);
+
+    Cell curr(start, heuristic(start, goal), heuristic(start, goal));
+    gScore[start] = 0;
+    toExplore.insert(curr);
+
+    bool found = false;
+    while (!found && !toExplore.isEmpty()) {
+        curr = toExplore.pop();
+
+        if (curr.coord == goal) {
+            found = true;
+        }
+        else {
+            int currG = gScore[curr.coord];
+
+            for (Cell neighbor : curr.getNeighbors()) {
+                if (grid.isOpen(neighbor.coord)) {
+                    int tentativeG = currG + 1;
+                    int bestKnown = gScore.contains(neighbor.coord) ?
+                        gScore[neighbor.coord] : INT_MAX;
+
+                    if (tentativeG < bestKnown) {
+                        gScore[neighbor.coord] = tentativeG;
+                        parent[neighbor.coord] = curr.coord;
+
+                        neighbor.h = heuristic(neighbor.coord, goal);
+                        neighbor.f = tentativeG + neighbor.h;
+                        toExplore.insert(neighbor);
+                    }
+                }
+            }
+        }
+    }
+
+    SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> route;
+    if (found) {
+        mcpp::Coordinate2D c = goal;
+        while (c != start) {
+            route.push_back(c);
+            c = parent[c];
+        }
+        route.push_back(start);
+    }
+
+    return route.getSize();
+}
+
+struct Result {
+    size_t allocs;
+    size_t bytes;
+    double micros;
+    size_t routeLen;
+};
+
+template<typename Fn>
+Result measure(int searches, Fn fn) {
+
+    size_t countBefore = g_allocCount;
+    size_t bytesBefore = g_allocBytes;
+    auto t0 = std::chrono::steady_clock::now();
+
+    size_t routeLen = 0;
+    for (int i = 0; i < searches; ++i) {
+        routeLen = fn();
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+    double micros = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+    return Result{(g_allocCount - countBefore) / searches,
+                  (g_allocBytes - bytesBefore) / searches,
+                  micros / searches,
+                  routeLen};
+}
+
+void report(const char* label, int size, const Result& r) {
+    std::printf("%-14s grid=%4d  allocs/search=%8zu  bytes/search=%10zu  "
+                "us/search=%9.1f  route=%zu\n",
+                label, size, r.allocs, r.bytes, r.micros, r.routeLen);
+}
+
+/**
+ * @brief Runs @p fn once under AllocStats and prints its storage by container.
+ */
+template<typename Fn>
+void reportKinds(const char* label, int size, Fn fn) {
+
+    AllocStats stats{};
+    fn();
+
+    for (int k = 0; k < AllocStats::KIND_COUNT; ++k) {
+        const AllocStats::Counters& kind = stats.get(AllocStats::Kind(k));
+
+        std::printf("%-14s grid=%4d  %-13s allocs=%6zu  grown=%6zu  bytes=%10zu  "
+                    "peak=%10lld\n",
+                    label, size, AllocStats::kindName(AllocStats::Kind(k)),
+                    kind.allocations, kind.reallocations, kind.bytes, kind.peakBytes);
+    }
+
+    return;
+}
+
+
+int main() {
+
+    const int SEARCHES = 20;
+    const int SIZES[] = {32, 128, 512};
+
+    Arena sharedArena{};
+
+    for (int size : SIZES) {
+
+        Grid grid = makeGrid(size, 20, 42);
+
+        Result heap = measure(SEARCHES, [&]() {
+            Map<mcpp::Coordinate2D, int> gScore{};
+            Map<mcpp::Coordinate2D, mcpp::Coordinate2D> parent{};
+            PriorityQueue<Cell> toExplore{};
+
+            return search(grid, gScore, parent, toExplore);
+        });
+
+        // one arena per search, as findPath does
+        Result arena = measure(SEARCHES, [&]() {
+            Arena local{};
+            OpenSet toExplore{ArenaAllocator<Cell>(&local)};
+            ScoreMap gScore(8, ScoreMap::allocator_type(&local));
+            ParentMap parent(8, ParentMap::allocator_type(&local));
+
+            return search(grid, gScore, parent, toExplore);
+        });
+
+        // one arena reused across searches, reset after each link
+        Result reused = measure(SEARCHES, [&]() {
+            size_t len = 0;
+            {
+                OpenSet toExplore{ArenaAllocator<Cell>(&sharedArena)};
+                ScoreMap gScore(8, ScoreMap::allocator_type(&sharedArena));
+                ParentMap parent(8, ParentMap::allocator_type(&sharedArena));
+
+                len = search(grid, gScore, parent, toExplore);
+            }
+            sharedArena.reset();
+
+            return len;
+        });
+
+        report("global heap", size, heap);
+        report("arena/search", size, arena);
+        report("arena reused", size, reused);
+
+        reportKinds("containers", size, [&]() {
+            Map<mcpp::Coordinate2D, int> gScore{};
+            Map<mcpp::Coordinate2D, mcpp::Coordinate2D> parent{};
+            PriorityQueue<Cell> toExplore{};
+
+            return search(grid, gScore, parent, toExplore);
+        });
+    }
+
+    return 0;
+}
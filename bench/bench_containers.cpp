@@ -0,0 +1,377 @@
+/**
+ * @file bench_containers.cpp
+ * @brief Microbenchmarks of Vector, Map/FlatMap and PriorityQueue against
+ *   their std counterparts.
+ *
+ * Every row times one operation on a custom container and on the std one
+ * with the same data, in ns per operation, and flags the rows where the
+ * custom container is more than 5% slower ("LOSES"):
+ * - Vector vs std::vector: push_back with growth, copy construction, copy
+ *   assignment, indexed reads, clear and refill.
+ * - Map and FlatMap vs std::unordered_map, with coordinate keys inserted in
+ *   the ring order of an A* expansion: inserts, hits and misses at the low
+ *   and high end of Map's load factor (just after and just before it
+ *   doubles), and a resize storm of many small maps grown from the default
+ *   capacity, as every search does.
+ * - PriorityQueue vs std::priority_queue of Cell: filling then draining,
+ *   and the A* mix of about three inserts per pop with many equal costs.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 bench/bench_containers.cpp src/Cell.cpp -lmcpp \
+ *       -o bench_containers
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/find_path.h"
+#include "../src/Vector.h"
+#include "../src/Map.h"
+#include "../src/FlatMap.h"
+#include "../src/Hash.h"
+#include "../src/PriorityQueue.h"
+#include "../src/Cell.h"
+
+
+static long g_sink = 0;
+
+template<typename Fn>
+double nsPerOp(size_t ops, int rounds, Fn fn) {
+
+    double best = 0;
+
+    // the fastest round, to keep scheduling noise out
+    for (int r = 0; r < rounds; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ops;
+        best = (r == 0) ? ns : std::min(best, ns);
+    }
+
+    return best;
+}
+
+void row(const char* group, const char* operation, size_t n,
+         double customNs, double stdNs) {
+
+    double ratio = customNs / stdNs;
+
+    std::printf("%-14s %-22s n=%8zu  custom=%8.2f ns  std=%8.2f ns  x%5.2f  %s\n",
+                group, operation, n, customNs, stdNs, ratio,
+                ratio > 1.05 ? "LOSES" : "");
+}
+
+
+/* ------------------------------------------
+ * ---------------- Vector ------------------
+ * ------------------------------------------ */
+
+/**
+ * @brief Times one operation on Vector<T> and std::vector<T>.
+ */
+template<typename T>
+void benchVector(const char* group, size_t n, int rounds) {
+
+    std::vector<T> source(n);
+    for (size_t i = 0; i < n; ++i) {
+        source[i] = T(int(i), int(i * 7));
+    }
+
+    row(group, "push_back (growth)", n,
+        nsPerOp(n, rounds, [&]() {
+            Vector<T> v{};
+            for (size_t i = 0; i < n; ++i) {
+                v.push_back(source[i]);
+            }
+            g_sink += long(v.getSize());
+        }),
+        nsPerOp(n, rounds, [&]() {
+            std::vector<T> v{};
+            for (size_t i = 0; i < n; ++i) {
+                v.push_back(source[i]);
+            }
+            g_sink += long(v.size());
+        }));
+
+    Vector<T> custom(source);
+    std::vector<T> standard(source);
+
+    row(group, "copy construct", n,
+        nsPerOp(n, rounds, [&]() {
+            Vector<T> copy(custom);
+            g_sink += long(copy.getSize());
+        }),
+        nsPerOp(n, rounds, [&]() {
+            std::vector<T> copy(standard);
+            g_sink += long(copy.size());
+        }));
+
+    // assigning over a smaller target, so the storage has to grow
+    row(group, "copy assign", n,
+        nsPerOp(n, rounds, [&]() {
+            Vector<T> target(n / 2);
+            target = custom;
+            g_sink += long(target.getSize());
+        }),
+        nsPerOp(n, rounds, [&]() {
+            std::vector<T> target(n / 2);
+            target = standard;
+            g_sink += long(target.size());
+        }));
+
+    row(group, "operator[] read", n,
+        nsPerOp(n, rounds, [&]() {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += custom[i].x;
+            }
+            g_sink += sum;
+        }),
+        nsPerOp(n, rounds, [&]() {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += standard[i].x;
+            }
+            g_sink += sum;
+        }));
+
+    // the storage is kept, as for the per-search buffers that are reused
+    row(group, "clear + refill", n,
+        nsPerOp(n, rounds, [&]() {
+            custom.clear();
+            for (size_t i = 0; i < n; ++i) {
+                custom.push_back(source[i]);
+            }
+        }),
+        nsPerOp(n, rounds, [&]() {
+            standard.clear();
+            for (size_t i = 0; i < n; ++i) {
+                standard.push_back(source[i]);
+            }
+        }));
+}
+
+
+/* ------------------------------------------
+ * ----------------- Maps -------------------
+ * ------------------------------------------ */
+
+/**
+ * @brief The first @p count cells around @p center, in A* ring order.
+ */
+std::vector<mcpp::Coordinate2D> ringKeys(size_t count, int center) {
+
+    std::vector<mcpp::Coordinate2D> keys{};
+    keys.reserve(count);
+
+    for (int ring = 0; keys.size() < count; ++ring) {
+        for (int x = -ring; x <= ring && keys.size() < count; ++x) {
+            for (int z = -ring; z <= ring && keys.size() < count; ++z) {
+                if (std::abs(x) == ring || std::abs(z) == ring) {
+                    keys.push_back(mcpp::Coordinate2D(center + x, center + z));
+                }
+            }
+        }
+    }
+
+    return keys;
+}
+
+using StdMap = std::unordered_map<mcpp::Coordinate2D, int, CoordHash>;
+
+/**
+ * @brief Times insert, hit and miss of one custom map against std.
+ */
+template<typename M>
+void benchMap(const char* group, const char* load, size_t n, int rounds) {
+
+    std::vector<mcpp::Coordinate2D> keys = ringKeys(n, 0);
+    std::vector<mcpp::Coordinate2D> misses = ringKeys(n, 1 << 20);
+
+    M custom{};
+    StdMap standard{};
+
+    row(group, "insert", n,
+        nsPerOp(n, rounds, [&]() {
+            custom = M();
+            for (size_t i = 0; i < n; ++i) {
+                custom[keys[i]] = int(i);
+            }
+        }),
+        nsPerOp(n, rounds, [&]() {
+            standard = StdMap();
+            for (size_t i = 0; i < n; ++i) {
+                standard[keys[i]] = int(i);
+            }
+        }));
+
+    char label[32];
+
+    std::snprintf(label, sizeof(label), "hit (load %s)", load);
+    row(group, label, n,
+        nsPerOp(n, rounds, [&]() {
+            for (const mcpp::Coordinate2D& key : keys) {
+                g_sink += *custom.find(key);
+            }
+        }),
+        nsPerOp(n, rounds, [&]() {
+            for (const mcpp::Coordinate2D& key : keys) {
+                g_sink += standard.find(key)->second;
+            }
+        }));
+
+    std::snprintf(label, sizeof(label), "miss (load %s)", load);
+    row(group, label, n,
+        nsPerOp(n, rounds, [&]() {
+            for (const mcpp::Coordinate2D& key : misses) {
+                g_sink += custom.find(key) != nullptr ? 1 : 0;
+            }
+        }),
+        nsPerOp(n, rounds, [&]() {
+            for (const mcpp::Coordinate2D& key : misses) {
+                g_sink += standard.find(key) != standard.end() ? 1 : 0;
+            }
+        }));
+}
+
+/**
+ * @brief Many small maps grown from their default capacity, as the
+ *   per-search score and parent maps are.
+ */
+template<typename M>
+void benchResizeStorm(const char* group, size_t mapCount, size_t n, int rounds) {
+
+    std::vector<mcpp::Coordinate2D> keys = ringKeys(n, 0);
+
+    row(group, "resize storm", mapCount * n,
+        nsPerOp(mapCount * n, rounds, [&]() {
+            for (size_t m = 0; m < mapCount; ++m) {
+                M map{};
+                for (size_t i = 0; i < n; ++i) {
+                    map[keys[i]] = int(i);
+                }
+                g_sink += map.getSize();
+            }
+        }),
+        nsPerOp(mapCount * n, rounds, [&]() {
+            for (size_t m = 0; m < mapCount; ++m) {
+                StdMap map{};
+                for (size_t i = 0; i < n; ++i) {
+                    map[keys[i]] = int(i);
+                }
+                g_sink += long(map.size());
+            }
+        }));
+}
+
+
+/* ------------------------------------------
+ * ------------ Priority queue --------------
+ * ------------------------------------------ */
+
+using StdQueue = std::priority_queue<Cell, std::vector<Cell>, std::greater<Cell>>;
+
+/**
+ * @brief Costs of @p n cells; A* costs are small integers with many ties.
+ */
+std::vector<Cell> queueCells(size_t n) {
+
+    std::vector<Cell> cells{};
+    unsigned state = 12345;
+
+    for (size_t i = 0; i < n; ++i) {
+        state = state * 1103515245u + 12345u;
+        int f = int(i / 8) + int((state >> 16) % 32);
+        cells.push_back(Cell(mcpp::Coordinate2D(int(i), 0), f, f / 2));
+    }
+
+    return cells;
+}
+
+void benchQueue(size_t n, int rounds) {
+
+    std::vector<Cell> cells = queueCells(n);
+
+    row("PriorityQueue", "fill then drain", n,
+        nsPerOp(n, rounds, [&]() {
+            PriorityQueue<Cell> queue{};
+            for (const Cell& cell : cells) {
+                queue.insert(cell);
+            }
+            while (!queue.isEmpty()) {
+                g_sink += queue.pop().f;
+            }
+        }),
+        nsPerOp(n, rounds, [&]() {
+            StdQueue queue{};
+            for (const Cell& cell : cells) {
+                queue.push(cell);
+            }
+            while (!queue.empty()) {
+                g_sink += queue.top().f;
+                queue.pop();
+            }
+        }));
+
+    // each expansion pushes about three neighbors and pops one cell
+    row("PriorityQueue", "A* mix (3 in, 1 out)", n,
+        nsPerOp(n, rounds, [&]() {
+            PriorityQueue<Cell> queue{};
+            for (size_t i = 0; i < cells.size(); ++i) {
+                queue.insert(cells[i]);
+                if (i % 3 == 2) {
+                    g_sink += queue.pop().f;
+                }
+            }
+        }),
+        nsPerOp(n, rounds, [&]() {
+            StdQueue queue{};
+            for (size_t i = 0; i < cells.size(); ++i) {
+                queue.push(cells[i]);
+                if (i % 3 == 2) {
+                    g_sink += queue.top().f;
+                    queue.pop();
+                }
+            }
+        }));
+}
+
+
+int main() {
+
+    const int ROUNDS = 5;
+    const size_t VECTOR_SIZES[] = {1000, 100000, 1000000};
+
+    for (size_t n : VECTOR_SIZES) {
+        benchVector<mcpp::Coordinate2D>("Vector<Coord2D>", n, ROUNDS);
+    }
+
+    // Map doubles once it is half full, so 2^16 slots hold 0.26 just
+    // after growing from 2^15 and 0.49 just before the next doubling
+    const size_t SLOTS = size_t(1) << 16;
+    const size_t LOW = SLOTS * 26 / 100;
+    const size_t HIGH = SLOTS * 49 / 100;
+
+    benchMap<Map<mcpp::Coordinate2D, int>>("Map", "0.26", LOW, ROUNDS);
+    benchMap<Map<mcpp::Coordinate2D, int>>("Map", "0.49", HIGH, ROUNDS);
+    benchMap<FlatMap<mcpp::Coordinate2D, int, CoordHash>>("FlatMap", "0.26", LOW, ROUNDS);
+    benchMap<FlatMap<mcpp::Coordinate2D, int, CoordHash>>("FlatMap", "0.49", HIGH, ROUNDS);
+
+    benchResizeStorm<Map<mcpp::Coordinate2D, int>>("Map", 1000, 2000, ROUNDS);
+    benchResizeStorm<FlatMap<mcpp::Coordinate2D, int, CoordHash>>("FlatMap", 1000, 2000, ROUNDS);
+
+    const size_t QUEUE_SIZES[] = {1000, 100000, 1000000};
+    for (size_t n : QUEUE_SIZES) {
+        benchQueue(n, ROUNDS);
+    }
+
+    std::printf("(%ld)\n", g_sink % 10);
+
+    return 0;
+}
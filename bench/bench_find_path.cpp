@@ -0,0 +1,605 @@
+/**
+ * @file bench_find_path.cpp
+ * @brief findPath benchmark on synthetic terrain, with JSON output.
+ *
+ * Builds height maps, surface slabs and plot layouts in memory from seeded
+ * generators (flat, hills, ridges, lakes, plot mazes) and runs findPath
+ * over a matrix of region sizes, link lengths and obstacle densities. Each
+ * case reports ns per expansion, expansions, heap calls and heap bytes per
+ * query, and the peak heap growth of any query, one JSON object per line.
+ *
+ * With --baseline, the results are compared against an earlier output of
+ * this program: any case whose time per expansion, expansions, heap calls
+ * or peak bytes grew by more than --tolerance (a fraction, default 0.15)
+ * is listed on stderr and the exit status is 1. Expansions, heap calls and
+ * bytes are deterministic, so only the time needs the tolerance; compare
+ * runs from the same, otherwise idle machine, or raise it on shared hosts.
+ *
+ *   bench_find_path > baseline.json
+ *   bench_find_path --baseline baseline.json > current.json
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 bench/bench_find_path.cpp src/Cell.cpp src/Arena.cpp \
+ *       src/find_path.cpp src/SurfaceSlab.cpp src/OccupancyGrid.cpp src/Trace.cpp \
+ *       -lmcpp -lpthread -o bench_find_path
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../src/find_path.h"
+
+
+/* ------------------------------------------
+ * ------ Global allocation counting --------
+ * ------------------------------------------ */
+
+// every block carries its size and the address malloc returned in front,
+// so frees can be subtracted and over-aligned blocks released
+static const size_t HEADER_BYTES = 2 * sizeof(size_t);
+
+static size_t g_allocCount = 0;
+static size_t g_allocBytes = 0;
+static size_t g_liveBytes = 0;
+static size_t g_peakBytes = 0;
+
+/**
+ * @brief Allocates @p bytes aligned to @p align behind a size header.
+ */
+static void* countedNew(size_t bytes, size_t align) {
+    ++g_allocCount;
+    g_allocBytes += bytes;
+    g_liveBytes += bytes;
+    g_peakBytes = std::max(g_peakBytes, g_liveBytes);
+
+    void* base = std::malloc(bytes + HEADER_BYTES + align);
+    if (base == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    // addresses are handled as integers, so the header is not seen as an
+    // access outside the caller's object
+    uintptr_t user = (reinterpret_cast<uintptr_t>(base) + HEADER_BYTES + align - 1)
+                     / align * align;
+    size_t* header = reinterpret_cast<size_t*>(user - HEADER_BYTES);
+    header[0] = bytes;
+    header[1] = reinterpret_cast<uintptr_t>(base);
+
+    return reinterpret_cast<void*>(user);
+}
+
+/**
+ * @brief Frees a block from countedNew, whatever its alignment.
+ */
+static void countedDelete(void* p) noexcept {
+    if (p != nullptr) {
+        size_t* header = reinterpret_cast<size_t*>(reinterpret_cast<uintptr_t>(p)
+                                                   - HEADER_BYTES);
+        g_liveBytes -= header[0];
+        std::free(reinterpret_cast<void*>(header[1]));
+    }
+}
+
+void* operator new(size_t bytes) {
+    return countedNew(bytes, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t bytes) {
+    return countedNew(bytes, alignof(std::max_align_t));
+}
+
+void* operator new(size_t bytes, std::align_val_t align) {
+    return countedNew(bytes, std::max(size_t(align), alignof(std::max_align_t)));
+}
+
+void* operator new[](size_t bytes, std::align_val_t align) {
+    return countedNew(bytes, std::max(size_t(align), alignof(std::max_align_t)));
+}
+
+void operator delete(void* p) noexcept {
+    countedDelete(p);
+}
+
+void operator delete[](void* p) noexcept {
+    countedDelete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    countedDelete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    countedDelete(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    countedDelete(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    countedDelete(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    countedDelete(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    countedDelete(p);
+}
+
+
+/* ------------------------------------------
+ * ------------- Terrain --------------------
+ * ------------------------------------------ */
+
+/**
+ * @brief A generated region: everything findPath reads.
+ */
+struct Terrain {
+    mcpp::HeightMap heightMap;
+    SurfaceSlab surface;
+    std::vector<Plot> plots;
+    Plot border;
+};
+
+/**
+ * @brief Small deterministic generator (xorshift64).
+ */
+struct Rng {
+    uint64_t state;
+
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    int below(int bound) {
+        return int(next() % uint64_t(bound));
+    }
+};
+
+const int BASE_HEIGHT = 64;
+const int SEA_LEVEL = 62;
+
+/**
+ * @brief Wraps heights (x-major, side x side) and water flags into a Terrain.
+ */
+Terrain makeTerrain(int side, const std::vector<int>& heights,
+                    const std::vector<char>& isWater, std::vector<Plot> plots) {
+
+    mcpp::Coordinate lo(0, 0, 0);
+    mcpp::Coordinate hi(side - 1, 0, side - 1);
+    mcpp::HeightMap heightMap(lo, hi, heights);
+
+    SurfaceSlab surface(heightMap);
+    for (int x = 0; x < side; ++x) {
+        for (int z = 0; z < side; ++z) {
+            mcpp::Coordinate2D column(x, z);
+            int height = heights[size_t(x) * side + z];
+
+            for (int y = surface.bottomAt(column); y < height; ++y) {
+                surface.set(mcpp::Coordinate(x, y, z), mcpp::Blocks::DIRT);
+            }
+            surface.set(mcpp::Coordinate(x, height, z),
+                        isWater[size_t(x) * side + z] ? mcpp::Blocks::STILL_WATER
+                                                      : mcpp::Blocks::GRASS);
+        }
+    }
+
+    // isInBorder is exclusive, so the border sits one cell outside the region
+    Plot border{mcpp::Coordinate(-1, 0, -1), mcpp::Coordinate(side, 0, side)};
+
+    return Terrain{heightMap, surface, plots, border};
+}
+
+/**
+ * @brief Flat grass; @p density is ignored.
+ */
+Terrain flat(int side, int, uint64_t) {
+    return makeTerrain(side, std::vector<int>(size_t(side) * side, BASE_HEIGHT),
+                       std::vector<char>(size_t(side) * side, 0), {});
+}
+
+/**
+ * @brief Smooth value noise (6 blocks) with @p density percent of the
+ *   16-cell lattice points raised 16 blocks into peaks, costly to climb.
+ */
+Terrain hills(int side, int density, uint64_t seed) {
+
+    const int CELL = 16;
+    int lattice = side / CELL + 2;
+
+    Rng rng{seed};
+    std::vector<int> points(size_t(lattice) * lattice);
+    for (int& point : points) {
+        point = rng.below(7) + (rng.below(100) < density ? 16 : 0);
+    }
+
+    std::vector<int> heights(size_t(side) * side);
+    for (int x = 0; x < side; ++x) {
+        for (int z = 0; z < side; ++z) {
+            int cx = x / CELL;
+            int cz = z / CELL;
+            double fx = double(x % CELL) / CELL;
+            double fz = double(z % CELL) / CELL;
+
+            double top = points[size_t(cx) * lattice + cz] * (1 - fz) +
+                         points[size_t(cx) * lattice + cz + 1] * fz;
+            double bottom = points[size_t(cx + 1) * lattice + cz] * (1 - fz) +
+                            points[size_t(cx + 1) * lattice + cz + 1] * fz;
+
+            heights[size_t(x) * side + z] = BASE_HEIGHT + int(top * (1 - fx) + bottom * fx);
+        }
+    }
+
+    return makeTerrain(side, heights, std::vector<char>(size_t(side) * side, 0), {});
+}
+
+/**
+ * @brief Walls across z every 24 cells, 10 blocks high; @p density percent
+ *   of each wall is closed, the rest left as gaps.
+ */
+Terrain ridges(int side, int density, uint64_t seed) {
+
+    const int SPACING = 24;
+    const int SEGMENT = 8;
+
+    Rng rng{seed};
+    std::vector<int> heights(size_t(side) * side, BASE_HEIGHT);
+
+    for (int x = SPACING; x < side; x += SPACING) {
+        for (int z = 0; z < side; z += SEGMENT) {
+            if (rng.below(100) < density) {
+                for (int dz = z; dz < std::min(side, z + SEGMENT); ++dz) {
+                    heights[size_t(x) * side + dz] = BASE_HEIGHT + 10;
+                    heights[size_t(x + 1 < side ? x + 1 : x) * side + dz] = BASE_HEIGHT + 10;
+                }
+            }
+        }
+    }
+
+    return makeTerrain(side, heights, std::vector<char>(size_t(side) * side, 0), {});
+}
+
+/**
+ * @brief Round lakes at sea level covering about @p density percent of the
+ *   region; water can be crossed, at a penalty.
+ */
+Terrain lakes(int side, int density, uint64_t seed) {
+
+    const int RADIUS = 10;
+
+    Rng rng{seed};
+    std::vector<int> heights(size_t(side) * side, BASE_HEIGHT);
+    std::vector<char> isWater(size_t(side) * side, 0);
+
+    // a lake covers about 3 * RADIUS^2 cells
+    int lakeCount = side * side * density / (100 * 3 * RADIUS * RADIUS);
+
+    for (int i = 0; i < lakeCount; ++i) {
+        int cx = rng.below(side);
+        int cz = rng.below(side);
+
+        for (int x = std::max(0, cx - RADIUS); x < std::min(side, cx + RADIUS); ++x) {
+            for (int z = std::max(0, cz - RADIUS); z < std::min(side, cz + RADIUS); ++z) {
+                if ((x - cx) * (x - cx) + (z - cz) * (z - cz) < RADIUS * RADIUS) {
+                    heights[size_t(x) * side + z] = SEA_LEVEL;
+                    isWater[size_t(x) * side + z] = 1;
+                }
+            }
+        }
+    }
+
+    return makeTerrain(side, heights, isWater, {});
+}
+
+/**
+ * @brief Flat ground split into 12-cell blocks, @p density percent of which
+ *   are 10x10 plots; the 2-cell streets between them stay open.
+ */
+Terrain maze(int side, int density, uint64_t seed) {
+
+    const int BLOCK = 12;
+    const int PLOT = 10;
+
+    Rng rng{seed};
+    std::vector<Plot> plots{};
+
+    for (int x = 0; x + PLOT <= side; x += BLOCK) {
+        for (int z = 0; z + PLOT <= side; z += BLOCK) {
+            if (rng.below(100) < density) {
+                plots.push_back(Plot{mcpp::Coordinate(x, 0, z),
+                                     mcpp::Coordinate(x + PLOT - 1, 0, z + PLOT - 1)});
+            }
+        }
+    }
+
+    return makeTerrain(side, std::vector<int>(size_t(side) * side, BASE_HEIGHT),
+                       std::vector<char>(size_t(side) * side, 0), plots);
+}
+
+
+/* ------------------------------------------
+ * ------------- Measurement ----------------
+ * ------------------------------------------ */
+
+/**
+ * @brief One row of the output.
+ */
+struct CaseResult {
+    std::string name;
+    int queries = 0;
+    int found = 0;
+    double nsPerExpansion = 0;
+    double expansionsPerQuery = 0;
+    double allocsPerQuery = 0;
+    double bytesPerQuery = 0;
+    double peakBytes = 0;
+};
+
+/**
+ * @brief Endpoints of query @p i: a link of length @p length along x,
+ *   centred in the region, on a street row and moved off any plot.
+ */
+Path queryPath(const Terrain& terrain, int side, int length, int i) {
+
+    // streets of the maze lie on rows 10 and 11 of every 12
+    int z = std::min(side - 2, (side / 2) / 12 * 12 + 10 + 12 * (i % 3 - 1));
+    int x0 = std::max(1, side / 2 - length / 2 + i);
+    int x1 = std::min(side - 2, x0 + length);
+
+    Path path{};
+    path.start = mcpp::Coordinate(x0, terrain.heightMap.get_worldspace(mcpp::Coordinate2D(x0, z)), z);
+    path.end = mcpp::Coordinate(x1, terrain.heightMap.get_worldspace(mcpp::Coordinate2D(x1, z)), z);
+
+    return path;
+}
+
+/**
+ * @brief Removes plots holding an endpoint of any query, so every query
+ *   starts and ends on open ground.
+ */
+void clearEndpoints(Terrain& terrain, const std::vector<Path>& paths) {
+
+    auto holdsEndpoint = [&paths](const Plot& plot) {
+        bool holds = false;
+        for (const Path& path : paths) {
+            holds = holds || isInPlot(path.start, plot) || isInPlot(path.end, plot);
+        }
+        return holds;
+    };
+
+    terrain.plots.erase(std::remove_if(terrain.plots.begin(), terrain.plots.end(),
+                                       holdsEndpoint),
+                        terrain.plots.end());
+}
+
+CaseResult runCase(const std::string& name, Terrain terrain, int side, int length,
+                   int queries, int repeats) {
+
+    std::vector<Path> paths{};
+    for (int i = 0; i < queries; ++i) {
+        paths.push_back(queryPath(terrain, side, length, i));
+    }
+    clearEndpoints(terrain, paths);
+
+    OccupancyGrid occupied{};
+
+    CaseResult result{};
+    result.name = name;
+    result.queries = queries;
+
+    double totalNs = 0;
+    size_t totalExpansions = 0;
+    size_t totalAllocs = 0;
+    size_t totalBytes = 0;
+
+    for (const Path& path : paths) {
+        double bestNs = 0;
+
+        // the fastest of a few runs, to keep scheduling noise out
+        for (int r = 0; r < repeats; ++r) {
+            SearchReport report{};
+
+            size_t allocsBefore = g_allocCount;
+            size_t bytesBefore = g_allocBytes;
+            size_t liveBefore = g_liveBytes;
+            g_peakBytes = g_liveBytes;
+
+            auto t0 = std::chrono::steady_clock::now();
+            SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> plan = findPath(
+                path, terrain.plots, terrain.border, terrain.heightMap,
+                terrain.surface, occupied, &report);
+            auto t1 = std::chrono::steady_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+
+            if (r == 0) {
+                result.found += plan.getSize() > 0 ? 1 : 0;
+                totalExpansions += report.expanded;
+                totalAllocs += g_allocCount - allocsBefore;
+                totalBytes += g_allocBytes - bytesBefore;
+                result.peakBytes = std::max(result.peakBytes,
+                                            double(g_peakBytes - liveBefore));
+                bestNs = ns;
+            }
+            bestNs = std::min(bestNs, ns);
+        }
+
+        totalNs += bestNs;
+    }
+
+    result.nsPerExpansion = totalExpansions > 0 ? totalNs / totalExpansions : 0;
+    result.expansionsPerQuery = double(totalExpansions) / queries;
+    result.allocsPerQuery = double(totalAllocs) / queries;
+    result.bytesPerQuery = double(totalBytes) / queries;
+
+    return result;
+}
+
+void printJson(const CaseResult& r, bool isLast) {
+    std::printf("    {\"name\": \"%s\", \"queries\": %d, \"found\": %d, "
+                "\"ns_per_expansion\": %.2f, \"expansions_per_query\": %.1f, "
+                "\"allocs_per_query\": %.1f, \"bytes_per_query\": %.0f, "
+                "\"peak_bytes\": %.0f}%s\n",
+                r.name.c_str(), r.queries, r.found, r.nsPerExpansion,
+                r.expansionsPerQuery, r.allocsPerQuery, r.bytesPerQuery,
+                r.peakBytes, isLast ? "" : ",");
+}
+
+
+/* ------------------------------------------
+ * ------------- Baseline -------------------
+ * ------------------------------------------ */
+
+/**
+ * @brief Reads the number after "key": on a line of our own output.
+ */
+double fieldOf(const std::string& line, const char* key) {
+
+    std::string pattern = std::string("\"") + key + "\": ";
+    size_t pos = line.find(pattern);
+
+    return pos == std::string::npos ? 0 : std::atof(line.c_str() + pos + pattern.size());
+}
+
+/**
+ * @brief Lists the cases that got worse than the baseline by more than
+ *   @p tolerance.
+ * @return Number of regressions.
+ */
+int compareBaseline(const char* path, const std::vector<CaseResult>& results,
+                    double tolerance) {
+
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "cannot read baseline %s\n", path);
+        return 1;
+    }
+
+    int regressions = 0;
+    std::string line{};
+
+    while (std::getline(in, line)) {
+        size_t nameAt = line.find("\"name\": \"");
+
+        if (nameAt != std::string::npos) {
+            size_t from = nameAt + std::strlen("\"name\": \"");
+            std::string name = line.substr(from, line.find('"', from) - from);
+
+            for (const CaseResult& r : results) {
+                if (r.name == name) {
+                    struct { const char* key; double now; } metrics[] = {
+                        {"ns_per_expansion", r.nsPerExpansion},
+                        {"expansions_per_query", r.expansionsPerQuery},
+                        {"allocs_per_query", r.allocsPerQuery},
+                        {"peak_bytes", r.peakBytes},
+                    };
+
+                    for (const auto& metric : metrics) {
+                        double before = fieldOf(line, metric.key);
+
+                        if (metric.now > before * (1 + tolerance) && metric.now - before > 0.5) {
+                            std::fprintf(stderr, "REGRESSION %s %s: %.2f -> %.2f (%+.0f%%)\n",
+                                         name.c_str(), metric.key, before, metric.now,
+                                         before > 0 ? 100 * (metric.now / before - 1) : 100.0);
+                            ++regressions;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::fprintf(stderr, "%d regression(s) against %s\n", regressions, path);
+
+    return regressions;
+}
+
+
+int main(int argc, char** argv) {
+
+    const char* baseline = nullptr;
+    double tolerance = 0.15;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--baseline") == 0) {
+            baseline = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--tolerance") == 0) {
+            tolerance = std::atof(argv[i + 1]);
+        }
+    }
+
+    const int QUERIES = 6;
+    const int REPEATS = 5;
+    const uint64_t SEED = 42;
+
+    const int SIDES[] = {64, 256, 512};
+    const int LENGTH_PERCENT[] = {25, 50, 90};
+    const int DENSITIES[] = {0, 15, 30};
+
+    struct Generator {
+        const char* name;
+        Terrain (*make)(int, int, uint64_t);
+        bool usesDensity;
+    };
+    const Generator GENERATORS[] = {
+        {"flat", flat, false},
+        {"hills", hills, true},
+        {"ridges", ridges, true},
+        {"lakes", lakes, true},
+        {"maze", maze, true},
+    };
+
+    // findPath reports failed searches on std::cout; keep stdout pure JSON
+    std::cout.setstate(std::ios::failbit);
+
+    std::vector<CaseResult> results{};
+
+    for (const Generator& generator : GENERATORS) {
+        for (int side : SIDES) {
+            for (int density : DENSITIES) {
+                if (density == 0 || generator.usesDensity) {
+                    Terrain terrain = generator.make(side, density, SEED);
+
+                    for (int lengthPercent : LENGTH_PERCENT) {
+                        int length = side * lengthPercent / 100;
+                        std::string name = std::string(generator.name) + "/" +
+                            std::to_string(side) + "/len" + std::to_string(length) +
+                            "/d" + std::to_string(density);
+
+                        results.push_back(runCase(name, terrain, side, length,
+                                                  QUERIES, REPEATS));
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("{\n  \"benchmark\": \"find_path\",\n  \"cases\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        printJson(results[i], i + 1 == results.size());
+    }
+    std::printf("  ]\n}\n");
+
+    int regressions = 0;
+    if (baseline != nullptr) {
+        regressions = compareBaseline(baseline, results, tolerance);
+    }
+
+    return regressions > 0 ? 1 : 0;
+}
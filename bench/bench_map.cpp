@@ -0,0 +1,103 @@
+/**
+ * @file bench_map.cpp
+ * @brief Microbenchmarks of Map vs FlatMap with coordinate keys.
+ *
+ * Keys are the cells of a square region, inserted in the ring order an A*
+ * expansion produces. Measures insert, successful lookup and miss lookup
+ * (keys of an equal region offset by four sides along both axes, so none
+ * is present) in ns per operation.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 bench/bench_map.cpp src/Arena.cpp -lmcpp -o bench_map
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../src/find_path.h"
+
+
+/**
+ * @brief Cells of a side x side square, ordered by distance from its centre.
+ */
+std::vector<mcpp::Coordinate2D> regionKeys(int side, int offset) {
+
+    std::vector<mcpp::Coordinate2D> keys;
+    keys.reserve(size_t(side) * side);
+
+    int half = side / 2;
+    for (int ring = 0; ring <= half; ++ring) {
+        for (int x = -ring; x <= ring; ++x) {
+            for (int z = -ring; z <= ring; ++z) {
+                bool onRing = std::abs(x) == ring || std::abs(z) == ring;
+                if (onRing && x + half < side && z + half < side) {
+                    keys.push_back(mcpp::Coordinate2D(offset + x, offset + z));
+                }
+            }
+        }
+    }
+
+    return keys;
+}
+
+template<typename Fn>
+double nsPerOp(size_t ops, Fn fn) {
+
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / ops;
+}
+
+/**
+ * @brief Runs insert / hit / miss rounds for one map type.
+ */
+template<typename M>
+void run(const char* label, const std::vector<mcpp::Coordinate2D>& keys,
+         const std::vector<mcpp::Coordinate2D>& misses) {
+
+    M map{};
+    long sink = 0;
+
+    double insertNs = nsPerOp(keys.size(), [&]() {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            map[keys[i]] = int(i);
+        }
+    });
+
+    double hitNs = nsPerOp(keys.size(), [&]() {
+        for (const mcpp::Coordinate2D& key : keys) {
+            sink += *map.find(key);
+        }
+    });
+
+    double missNs = nsPerOp(misses.size(), [&]() {
+        for (const mcpp::Coordinate2D& key : misses) {
+            sink += map.contains(key) ? 1 : 0;
+        }
+    });
+
+    std::printf("%-22s n=%8zu  insert=%7.1f ns  hit=%7.1f ns  miss=%7.1f ns  (%ld)\n",
+                label, keys.size(), insertNs, hitNs, missNs, sink % 10);
+}
+
+
+int main() {
+
+    // the old Map degrades badly past ~1M keys, so stop there
+    const int SIDES[] = {32, 316, 1000};
+
+    for (int side : SIDES) {
+
+        std::vector<mcpp::Coordinate2D> keys = regionKeys(side, 0);
+        std::vector<mcpp::Coordinate2D> misses = regionKeys(side, side * 4);
+
+        run<Map<mcpp::Coordinate2D, int>>("Map (std::hash)", keys, misses);
+        run<FlatMap<mcpp::Coordinate2D, int>>("FlatMap (std::hash)", keys, misses);
+        run<FlatMap<mcpp::Coordinate2D, int, CoordHash>>("FlatMap (CoordHash)", keys, misses);
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file bench_village.cpp
+ * @brief End-to-end connectPoints benchmark on generated villages.
+ *
+ * Lays out villages of 10 to 2,000 houses on a SimulatedWorld with an
+ * injected per-call latency, and connects every house door to the
+ * village's waypoints. Houses sit on 12x12 plots in a grid with 8-block
+ * streets, and there is one waypoint per four houses at street crossings.
+ *
+ * Each row is one village: the links found out of those requested, wall
+ * time split into the fetch, search, build and link-selection phases of
+ * ConnectReport, the time per house (which grows with the village where a
+ * part is superlinear), the backend round trips (height, block and write
+ * calls) and the blocks written. Roads may not cross earlier roads, so
+ * some houses end up isolated, more so in larger villages.
+ *
+ *   bench_village [--latency-us N] [--max-houses N] [--pipelined] [--trace FILE]
+ *
+ * --trace writes a Chrome trace of the largest village to FILE; build with
+ * -DPATHFIND_TRACE for it to hold any spans.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 bench/bench_village.cpp src/AllocStats.cpp src/Arena.cpp \
+ *       src/BlockWriteBuffer.cpp src/Cell.cpp src/ConnectionPool.cpp \
+ *       src/LinkSelector.cpp src/McppBackend.cpp src/OccupancyGrid.cpp \
+ *       src/PlanReader.cpp src/PlanWriter.cpp src/SimulatedWorld.cpp \
+ *       src/SurfaceSlab.cpp src/Trace.cpp src/WorldModel.cpp \
+ *       src/WorldSnapshot.cpp src/build_path.cpp src/connect_points.cpp \
+ *       src/find_path.cpp src/plan_network.cpp -lmcpp -lpthread -o bench_village
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "../src/connect_points.h"
+#include "../src/ConnectionPool.h"
+#include "../src/SimulatedWorld.h"
+
+
+/**
+ * @brief A generated village: plots, doors, waypoints and border.
+ */
+struct Village {
+    std::vector<Plot> plots;
+    std::vector<mcpp::Coordinate> doors;
+    std::vector<mcpp::Coordinate> waypoints;
+    Plot border;
+};
+
+const int PLOT_SIDE = 12;
+const int STREET = 8;
+const int PITCH = PLOT_SIDE + STREET;
+const int HOUSES_PER_WAYPOINT = 4;
+
+/**
+ * @brief Lays out @p houses plots in a square grid on @p world's terrain.
+ *
+ * Doors face north onto the street in front of their plot; waypoints are
+ * spread over the street crossings in row order.
+ */
+Village makeVillage(const SimulatedWorld& world, int houses) {
+
+    Village village{};
+    int columns = int(std::ceil(std::sqrt(double(houses))));
+    int rows = (houses + columns - 1) / columns;
+
+    auto onGround = [&world](int x, int z) {
+        return mcpp::Coordinate(x, world.getHeight(mcpp::Coordinate2D(x, z)), z);
+    };
+
+    for (int i = 0; i < houses; ++i) {
+        int x = (i % columns) * PITCH + STREET;
+        int z = (i / columns) * PITCH + STREET;
+
+        village.plots.push_back(Plot{mcpp::Coordinate(x, 0, z),
+            mcpp::Coordinate(x + PLOT_SIDE - 1, 0, z + PLOT_SIDE - 1)});
+        village.doors.push_back(onGround(x + PLOT_SIDE / 2, z - 1));
+    }
+
+    int crossings = (columns + 1) * (rows + 1);
+    int waypoints = houses / HOUSES_PER_WAYPOINT + 1;
+
+    for (int i = 0; i < waypoints; ++i) {
+        int crossing = int((long long)(i) * crossings / waypoints);
+        village.waypoints.push_back(onGround((crossing % (columns + 1)) * PITCH + STREET / 2,
+                                             (crossing / (columns + 1)) * PITCH + STREET / 2));
+    }
+
+    village.border = Plot{mcpp::Coordinate(-SIDE_INCREASE, 0, -SIDE_INCREASE),
+                          mcpp::Coordinate(columns * PITCH + STREET + SIDE_INCREASE, 0,
+                                           rows * PITCH + STREET + SIDE_INCREASE)};
+
+    return village;
+}
+
+/**
+ * @brief Prints one village: phases, per-house time, round trips and writes.
+ */
+void row(int houses, const ConnectReport& report, const SimulatedWorld::Stats& stats) {
+
+    size_t roundTrips = stats.heightCalls + stats.blockCalls + stats.writeCalls;
+
+    std::printf("%5d %5zu/%-5d %9.1f %9.1f %9.1f %9.1f %9.1f %8.3f %8zu %9zu\n",
+                houses, report.links, houses,
+                report.totalSeconds * 1e3, report.fetchSeconds * 1e3,
+                report.searchSeconds * 1e3, report.buildSeconds * 1e3,
+                report.selectSeconds * 1e3, report.totalSeconds * 1e3 / houses,
+                roundTrips, stats.blocksWritten);
+}
+
+
+int main(int argc, char** argv) {
+
+    SimulatedWorld::Options worldOptions{};
+    worldOptions.latency = std::chrono::microseconds(200);
+    int maxHouses = 2000;
+    ConnectOptions options{};
+    const char* tracePath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--latency-us") == 0 && i + 1 < argc) {
+            worldOptions.latency = std::chrono::microseconds(std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--max-houses") == 0 && i + 1 < argc) {
+            maxHouses = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--pipelined") == 0) {
+            options.pipelined = true;
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        }
+        else {
+            std::fprintf(stderr, "usage: %s [--latency-us N] [--max-houses N] "
+                         "[--pipelined] [--trace FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const int HOUSES[] = {10, 50, 200, 500, 1000, 2000};
+
+    int largest = 0;
+    for (int houses : HOUSES) {
+        largest = houses <= maxHouses ? houses : largest;
+    }
+
+    std::printf("%5s %11s %9s %9s %9s %9s %9s %8s %8s %9s\n",
+                "homes", "links", "total ms", "fetch", "search", "build",
+                "select", "ms/house", "trips", "blocks");
+
+    // findPath reports every isolated house on std::cout
+    std::cout.setstate(std::ios::failbit);
+
+    for (int houses : HOUSES) {
+        if (houses > maxHouses) {
+            continue;
+        }
+
+        // a fresh world per village, so no village sees another's roads
+        SimulatedWorld world(worldOptions);
+        ConnectionPool pool(world, 4, 32);
+        Village village = makeVillage(world, houses);
+
+        ConnectReport report{};
+        options.report = &report;
+
+        std::ofstream traceFile{};
+        options.traceOut = nullptr;
+        if (tracePath != nullptr && houses == largest) {
+            traceFile.open(tracePath);
+            options.traceOut = &traceFile;
+        }
+
+        std::vector<mcpp::Coordinate> connected = village.waypoints;
+        std::vector<mcpp::Coordinate> unconnected = village.doors;
+
+        connectPoints(connected, unconnected, village.plots, village.border, pool,
+                      true, false, options);
+        row(houses, report, world.getStats());
+    }
+
+    return 0;
+}
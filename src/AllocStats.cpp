@@ -0,0 +1,54 @@
+#include "AllocStats.h"
+
+#include <algorithm>
+
+
+AllocStats::AllocStats() : outer(current) {
+    current = this;
+}
+
+
+AllocStats::~AllocStats() {
+
+    current = outer;
+
+    if (outer != nullptr) {
+        for (int k = 0; k < KIND_COUNT; ++k) {
+            merge(outer->kinds[k], kinds[k]);
+        }
+        merge(outer->all, all);
+    }
+}
+
+
+const AllocStats::Counters& AllocStats::get(Kind kind) const {
+    return kinds[kind];
+}
+
+
+const AllocStats::Counters& AllocStats::total() const {
+    return all;
+}
+
+
+const char* AllocStats::kindName(Kind kind) {
+
+    const char* const NAMES[KIND_COUNT] = {"Vector", "Map", "FlatMap", "PriorityQueue"};
+
+    return NAMES[kind];
+}
+
+
+void AllocStats::merge(Counters& outer, const Counters& inner) {
+
+    outer.allocations += inner.allocations;
+    outer.reallocations += inner.reallocations;
+    outer.bytes += inner.bytes;
+
+    // the inner peak was reached on top of what the outer scope held
+    outer.peakBytes = std::max(outer.peakBytes, outer.liveBytes + inner.peakBytes);
+    outer.liveBytes += inner.liveBytes;
+
+    return;
+}
+
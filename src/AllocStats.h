@@ -0,0 +1,205 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Opt-in accounting of the custom containers' storage, per thread.
+ *
+ * While an AllocStats object lives, every allocation and free that a
+ * Vector makes on the constructing thread is counted in it, under the kind
+ * of container owning the storage: a plain Vector, a Map or FlatMap table,
+ * or a PriorityQueue heap. Map and FlatMap rehashes and Vector growth of
+ * existing storage also count as reallocations. The hooks are inline: with
+ * no AllocStats alive, a hook is one thread-local load and a branch, and
+ * code that never creates an AllocStats does not need AllocStats.cpp.
+ *
+ * Objects nest, e.g. one per search inside one per run: only the innermost
+ * counts, and it adds its counters to the enclosing one when destroyed.
+ * They must be destroyed in reverse order of construction, on the thread
+ * that constructed them. Bytes are those requested from the allocator, so
+ * Arena-backed containers are counted too.
+ */
+class AllocStats {
+    public:
+        enum Kind : uint8_t {
+            VECTOR,
+            MAP,
+            FLAT_MAP,
+            PRIORITY_QUEUE,
+            KIND_COUNT
+        };
+
+        /**
+         * @brief Counters of one kind (or of all kinds together).
+         */
+        struct Counters {
+            size_t allocations = 0;
+            size_t reallocations = 0;
+            size_t bytes = 0;
+
+            // storage allocated and not yet freed; negative if storage from
+            // before the scope was freed in it
+            long long liveBytes = 0;
+            long long peakBytes = 0;
+        };
+
+        /**
+         * @brief Starts counting the calling thread's container storage.
+         */
+        AllocStats();
+
+        /**
+         * @brief Stops counting and adds the counters to the enclosing
+         *   AllocStats, if any.
+         */
+        ~AllocStats();
+
+        AllocStats(const AllocStats&) = delete;
+        AllocStats& operator=(const AllocStats&) = delete;
+
+        /**
+         * @brief Returns the counters of one container kind.
+         * @param kind Kind below KIND_COUNT.
+         * @return Counters so far.
+         */
+        const Counters& get(Kind kind) const;
+
+        /**
+         * @brief Returns the counters of all kinds together.
+         *
+         * The peak is that of the combined live bytes, not the sum of the
+         * per-kind peaks.
+         *
+         * @return Counters so far.
+         */
+        const Counters& total() const;
+
+        /**
+         * @brief Returns the display name of a kind.
+         * @param kind Kind below KIND_COUNT.
+         * @return Name such as "Map".
+         */
+        static const char* kindName(Kind kind);
+
+        /**
+         * @brief Hook: storage of @p bytes was allocated for @p kind.
+         */
+        static void onAllocate(Kind kind, size_t bytes);
+
+        /**
+         * @brief Hook: storage of @p bytes owned by @p kind was freed.
+         */
+        static void onFree(Kind kind, size_t bytes);
+
+        /**
+         * @brief Hook: existing storage of @p kind was replaced by a larger one.
+         */
+        static void onReallocate(Kind kind);
+
+    private:
+        /**
+         * @brief Adds @p delta live bytes to @p counters and raises its peak.
+         */
+        static void addLive(Counters& counters, long long delta);
+
+        /**
+         * @brief Slow paths of the hooks, run only inside a scope.
+         */
+        void countAllocate(Kind kind, size_t bytes);
+        void countFree(Kind kind, size_t bytes);
+        void countReallocate(Kind kind);
+
+        /**
+         * @brief Adds the counters of a finished nested scope to @p outer.
+         */
+        static void merge(Counters& outer, const Counters& inner);
+
+        Counters kinds[KIND_COUNT];
+        Counters all;
+        AllocStats* outer;
+
+        // defined here so the hooks need nothing from AllocStats.cpp
+        static inline thread_local AllocStats* current = nullptr;
+};
+
+
+inline void AllocStats::onAllocate(Kind kind, size_t bytes) {
+
+    AllocStats* stats = current;
+
+    if (stats != nullptr) {
+        stats->countAllocate(kind, bytes);
+    }
+
+    return;
+}
+
+
+inline void AllocStats::onFree(Kind kind, size_t bytes) {
+
+    AllocStats* stats = current;
+
+    if (stats != nullptr) {
+        stats->countFree(kind, bytes);
+    }
+
+    return;
+}
+
+
+inline void AllocStats::onReallocate(Kind kind) {
+
+    AllocStats* stats = current;
+
+    if (stats != nullptr) {
+        stats->countReallocate(kind);
+    }
+
+    return;
+}
+
+
+inline void AllocStats::addLive(Counters& counters, long long delta) {
+
+    counters.liveBytes += delta;
+    if (counters.liveBytes > counters.peakBytes) {
+        counters.peakBytes = counters.liveBytes;
+    }
+
+    return;
+}
+
+
+inline void AllocStats::countAllocate(Kind kind, size_t bytes) {
+
+    ++kinds[kind].allocations;
+    ++all.allocations;
+    kinds[kind].bytes += bytes;
+    all.bytes += bytes;
+    addLive(kinds[kind], (long long)bytes);
+    addLive(all, (long long)bytes);
+
+    return;
+}
+
+
+inline void AllocStats::countFree(Kind kind, size_t bytes) {
+
+    addLive(kinds[kind], -(long long)bytes);
+    addLive(all, -(long long)bytes);
+
+    return;
+}
+
+
+inline void AllocStats::countReallocate(Kind kind) {
+
+    ++kinds[kind].reallocations;
+    ++all.reallocations;
+
+    return;
+}
+
+#endif
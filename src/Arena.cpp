@@ -0,0 +1,94 @@
+#include "Arena.h"
+
+#include <cstdint>
+#include <new>
+
+
+Arena::Arena(size_t firstBlockSize)
+    : nextBlockSize(firstBlockSize < 256 ? 256 : firstBlockSize)
+{}
+
+
+Arena::~Arena() {
+
+    while (head != nullptr) {
+        Block* prev = head->prev;
+        ::operator delete(head);
+        head = prev;
+    }
+}
+
+
+void Arena::grow(size_t minBytes) {
+
+    size_t blockSize = nextBlockSize;
+    while (blockSize < minBytes + sizeof(Block)) {
+        blockSize *= 2;
+    }
+
+    Block* block = static_cast<Block*>(::operator new(blockSize));
+    block->prev = head;
+    block->size = blockSize;
+
+    head = block;
+    cursor = reinterpret_cast<char*>(block) + sizeof(Block);
+    limit = reinterpret_cast<char*>(block) + blockSize;
+
+    // geometric growth keeps the block count logarithmic in the total size
+    nextBlockSize = blockSize * 2;
+    ++blocks;
+
+    return;
+}
+
+
+void* Arena::allocate(size_t bytes, size_t align) {
+
+    uintptr_t curr = reinterpret_cast<uintptr_t>(cursor);
+    uintptr_t aligned = (curr + (align - 1)) & ~uintptr_t(align - 1);
+
+    if (cursor == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        grow(bytes + align);
+
+        curr = reinterpret_cast<uintptr_t>(cursor);
+        aligned = (curr + (align - 1)) & ~uintptr_t(align - 1);
+    }
+
+    cursor = reinterpret_cast<char*>(aligned + bytes);
+    used += bytes;
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+
+void Arena::reset() {
+
+    if (head != nullptr) {
+
+        Block* prev = head->prev;
+        while (prev != nullptr) {
+            Block* next = prev->prev;
+            ::operator delete(prev);
+            prev = next;
+        }
+
+        head->prev = nullptr;
+        cursor = reinterpret_cast<char*>(head) + sizeof(Block);
+        limit = reinterpret_cast<char*>(head) + head->size;
+        blocks = 1;
+    }
+
+    used = 0;
+
+    return;
+}
+
+
+size_t Arena::bytesUsed() const {
+    return used;
+}
+
+
+size_t Arena::blockCount() const {
+    return blocks;
+}
@@ -0,0 +1,85 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+
+/**
+ * @brief A monotonic (bump) memory arena.
+ *
+ * Hands out memory by bumping a pointer inside large blocks taken from the
+ * global heap. Individual allocations are never freed; everything is given
+ * back at once by reset() or when the arena is destroyed. Intended for the
+ * short-lived containers of a single search, which then cost a handful of
+ * heap calls instead of thousands.
+ *
+ * Not thread-safe; use one arena per search.
+ */
+class Arena {
+    public:
+        /**
+         * @brief Constructs an arena. No memory is taken until first use.
+         * @param firstBlockSize Size in bytes of the first block (default 64 KiB).
+         */
+        explicit Arena(size_t firstBlockSize = 64 * 1024);
+
+        /**
+         * @brief Destructor. Frees every block.
+         */
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Allocates @p bytes with the given alignment.
+         * @param bytes Number of bytes requested.
+         * @param align Required alignment (power of two).
+         * @return Pointer to uninitialized memory owned by the arena.
+         */
+        void* allocate(size_t bytes, size_t align);
+
+        /**
+         * @brief Releases everything allocated so far.
+         *
+         * Keeps the most recent (largest) block for reuse, so an arena that
+         * is reset between searches stops touching the global heap once it
+         * has grown to the working-set size.
+         */
+        void reset();
+
+        /**
+         * @brief Returns the number of bytes handed out since the last reset.
+         * @return Bytes allocated from the arena.
+         */
+        size_t bytesUsed() const;
+
+        /**
+         * @brief Returns the number of blocks currently held.
+         * @return Number of heap blocks owned by the arena.
+         */
+        size_t blockCount() const;
+
+    private:
+        /**
+         * @brief Header placed at the start of every block.
+         */
+        struct Block {
+            Block* prev;
+            size_t size;
+        };
+
+        /**
+         * @brief Takes a new block from the heap large enough for @p minBytes.
+         * @param minBytes Minimum usable size of the block.
+         */
+        void grow(size_t minBytes);
+
+        Block* head = nullptr;
+        char* cursor = nullptr;
+        char* limit = nullptr;
+        size_t nextBlockSize;
+        size_t used = 0;
+        size_t blocks = 0;
+};
+
+#endif
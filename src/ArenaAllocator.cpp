@@ -0,0 +1,60 @@
+#include "ArenaAllocator.h"
+
+#include <new>
+
+
+template<typename T>
+ArenaAllocator<T>::ArenaAllocator(Arena* arena)
+    : arena(arena)
+{}
+
+template<typename T>
+template<typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other)
+    : arena(other.getArena())
+{}
+
+
+template<typename T>
+T* ArenaAllocator<T>::allocate(size_t n) {
+
+    void* mem = nullptr;
+
+    if (arena != nullptr) {
+        mem = arena->allocate(n * sizeof(T), alignof(T));
+    }
+    else {
+        mem = ::operator new(n * sizeof(T));
+    }
+
+    return static_cast<T*>(mem);
+}
+
+
+template<typename T>
+void ArenaAllocator<T>::deallocate(T* p, size_t) {
+
+    // arena memory is released all at once by the arena itself
+    if (arena == nullptr) {
+        ::operator delete(p);
+    }
+
+    return;
+}
+
+
+template<typename T>
+Arena* ArenaAllocator<T>::getArena() const {
+    return arena;
+}
+
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return !(a == b);
+}
@@ -0,0 +1,72 @@
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include <cstddef>
+
+#include "Arena.h"
+
+/**
+ * @brief Standard-conforming allocator that draws memory from an Arena.
+ *
+ * deallocate() is a no-op; memory returns to the arena when it is reset
+ * or destroyed. A default-constructed allocator has no arena and falls
+ * back to the global heap, so containers using it stay default-constructible.
+ *
+ * @tparam T Type of objects allocated.
+ */
+template<typename T>
+class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        /**
+         * @brief Constructs an allocator bound to @p arena.
+         * @param arena Arena to allocate from (nullptr = global heap).
+         */
+        ArenaAllocator(Arena* arena = nullptr);
+
+        /**
+         * @brief Rebinding constructor; shares the arena of @p other.
+         * @param other Allocator of another element type.
+         */
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other);
+
+        /**
+         * @brief Allocates storage for @p n objects of type T.
+         * @param n Number of objects.
+         * @return Pointer to uninitialized storage.
+         */
+        T* allocate(size_t n);
+
+        /**
+         * @brief Returns storage. Only frees when no arena is bound.
+         * @param p Pointer returned by allocate().
+         * @param n Number of objects passed to allocate().
+         */
+        void deallocate(T* p, size_t n);
+
+        /**
+         * @brief Returns the arena this allocator draws from.
+         * @return The bound arena, or nullptr for the global heap.
+         */
+        Arena* getArena() const;
+
+    private:
+        Arena* arena = nullptr;
+};
+
+/**
+ * @brief Two arena allocators are equal when they share the same arena.
+ */
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b);
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b);
+
+
+#include "ArenaAllocator.cpp"
+
+
+#endif
@@ -0,0 +1,194 @@
+#include "BlockWriteBuffer.h"
+
+#include <algorithm>
+
+#include "Trace.h"
+
+
+BlockWriteBuffer::BlockWriteBuffer() {}
+
+
+void BlockWriteBuffer::setBlock(const mcpp::Coordinate& coord,
+                                const mcpp::BlockType& type) {
+
+    pending.insert_or_assign(coord, type);
+
+    return;
+}
+
+
+void BlockWriteBuffer::setBlocks(const mcpp::Coordinate& first,
+                                 const mcpp::Coordinate& second,
+                                 const mcpp::BlockType& type) {
+
+    mcpp::Coordinate lo(std::min(first.x, second.x),
+                        std::min(first.y, second.y),
+                        std::min(first.z, second.z));
+    mcpp::Coordinate hi(std::max(first.x, second.x),
+                        std::max(first.y, second.y),
+                        std::max(first.z, second.z));
+
+    for (int y = lo.y; y <= hi.y; ++y) {
+        for (int x = lo.x; x <= hi.x; ++x) {
+            for (int z = lo.z; z <= hi.z; ++z) {
+                pending.insert_or_assign(mcpp::Coordinate(x, y, z), type);
+            }
+        }
+    }
+
+    return;
+}
+
+
+size_t BlockWriteBuffer::getSize() const {
+    return size_t(pending.getSize());
+}
+
+
+size_t BlockWriteBuffer::dropUnchanged(const SurfaceSlab& current) {
+
+    Vector<mcpp::Coordinate> unchanged{};
+
+    for (const auto& entry : pending) {
+        if (current.contains(entry.key) && current.get_worldspace(entry.key) == entry.value) {
+            unchanged.push_back(entry.key);
+        }
+    }
+
+    for (const mcpp::Coordinate& coord : unchanged) {
+        pending.erase(coord);
+    }
+
+    stats.blocksSkipped += unchanged.getSize();
+
+    return unchanged.getSize();
+}
+
+
+Vector<BlockWriteBuffer::Cuboid> BlockWriteBuffer::coalesce() const {
+
+    // cells not yet covered by a cuboid; erased as they are claimed
+    FlatMap<mcpp::Coordinate, mcpp::BlockType, BlockCoordHash> remaining(pending);
+
+    Vector<mcpp::Coordinate> order{};
+    for (const auto& entry : pending) {
+        order.push_back(entry.key);
+    }
+
+    // scan bottom-up so every cuboid starts at its minimum corner
+    std::sort(order.begin(), order.end(),
+        [](const mcpp::Coordinate& a, const mcpp::Coordinate& b) {
+            return (a.y != b.y) ? a.y < b.y
+                 : (a.x != b.x) ? a.x < b.x
+                 : a.z < b.z;
+        });
+
+    auto isFree = [&remaining](int x, int y, int z, const mcpp::BlockType& type) {
+        const mcpp::BlockType* found = remaining.find(mcpp::Coordinate(x, y, z));
+        return found != nullptr && *found == type;
+    };
+
+    Vector<Cuboid> cuboids{};
+
+    for (const mcpp::Coordinate& start : order) {
+        const mcpp::BlockType* startType = remaining.find(start);
+
+        if (startType != nullptr) {
+            mcpp::BlockType type = *startType;
+            mcpp::Coordinate end(start);
+
+            // grow along z
+            while (isFree(start.x, start.y, end.z + 1, type)) {
+                ++end.z;
+            }
+
+            // grow along x while the whole z run is free
+            bool canGrow = true;
+            while (canGrow) {
+                for (int z = start.z; z <= end.z && canGrow; ++z) {
+                    canGrow = isFree(end.x + 1, start.y, z, type);
+                }
+                if (canGrow) {
+                    ++end.x;
+                }
+            }
+
+            // grow along y while the whole x-z rectangle is free
+            canGrow = true;
+            while (canGrow) {
+                for (int x = start.x; x <= end.x && canGrow; ++x) {
+                    for (int z = start.z; z <= end.z && canGrow; ++z) {
+                        canGrow = isFree(x, end.y + 1, z, type);
+                    }
+                }
+                if (canGrow) {
+                    ++end.y;
+                }
+            }
+
+            for (int y = start.y; y <= end.y; ++y) {
+                for (int x = start.x; x <= end.x; ++x) {
+                    for (int z = start.z; z <= end.z; ++z) {
+                        remaining.erase(mcpp::Coordinate(x, y, z));
+                    }
+                }
+            }
+
+            cuboids.push_back(Cuboid{start, end, type});
+        }
+    }
+
+    // bottom-up so supports land before what rests on them, then grouped
+    // by 16x16 chunk so consecutive calls touch the same region
+    std::sort(cuboids.begin(), cuboids.end(),
+        [](const Cuboid& a, const Cuboid& b) {
+            int aChunkX = a.min.x >> 4;
+            int bChunkX = b.min.x >> 4;
+            int aChunkZ = a.min.z >> 4;
+            int bChunkZ = b.min.z >> 4;
+
+            return (a.min.y != b.min.y) ? a.min.y < b.min.y
+                 : (aChunkX != bChunkX) ? aChunkX < bChunkX
+                 : (aChunkZ != bChunkZ) ? aChunkZ < bChunkZ
+                 : (a.min.x != b.min.x) ? a.min.x < b.min.x
+                 : a.min.z < b.min.z;
+        });
+
+    return cuboids;
+}
+
+
+size_t BlockWriteBuffer::flush(WorldBackend& world) {
+
+    TRACE_SCOPE("BlockWriteBuffer::flush");
+
+    Vector<Cuboid> cuboids = coalesce();
+
+    stats.blocksIssued += getSize();
+    stats.calls += cuboids.getSize();
+
+    for (const Cuboid& cuboid : cuboids) {
+        if (cuboid.min == cuboid.max) {
+            world.setBlock(cuboid.min, cuboid.type);
+        } else {
+            world.setBlocks(cuboid.min, cuboid.max, cuboid.type);
+        }
+    }
+
+    clear();
+
+    return cuboids.getSize();
+}
+
+
+void BlockWriteBuffer::clear() {
+
+    pending.clear();
+
+    return;
+}
+
+
+BlockWriteBuffer::Stats BlockWriteBuffer::getStats() const {
+    return stats;
+}
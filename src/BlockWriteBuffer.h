@@ -0,0 +1,116 @@
+#ifndef BLOCK_WRITE_BUFFER_H
+#define BLOCK_WRITE_BUFFER_H
+
+#include <cstddef>
+#include <mcpp/mcpp.h>
+
+#include "Vector.h"
+#include "FlatMap.h"
+#include "Hash.h"
+#include "WorldBackend.h"
+#include "SurfaceSlab.h"
+
+/**
+ * @brief Collects block edits and sends them as few, large server calls.
+ *
+ * Every setBlock/setBlocks is recorded per cell; a later write to the same
+ * cell replaces the earlier one. flush() merges cells of the same block type
+ * into maximal cuboids (greedily along z, then x, then y) and issues one
+ * setBlocks per cuboid (setBlock for single cells), ordered bottom-up and
+ * chunk by chunk. Because each cell ends with its last written type, the
+ * placed result is the same as issuing the edits one by one, and supports
+ * are always placed before the blocks resting on them.
+ *
+ * Edits that would not change anything can be dropped beforehand with
+ * dropUnchanged(), given the blocks as they were before the edits.
+ */
+class BlockWriteBuffer {
+    public:
+        /**
+         * @brief An axis-aligned box of one block type.
+         */
+        struct Cuboid {
+            mcpp::Coordinate min;
+            mcpp::Coordinate max;
+            mcpp::BlockType type;
+        };
+
+        /**
+         * @brief Counters accumulated over all flushes.
+         */
+        struct Stats {
+            size_t blocksIssued = 0;
+            size_t blocksSkipped = 0;
+            size_t calls = 0;
+        };
+
+        /**
+         * @brief Creates an empty buffer.
+         */
+        BlockWriteBuffer();
+
+        /**
+         * @brief Records a single block edit.
+         * @param coord Block position.
+         * @param type Block to place.
+         */
+        void setBlock(const mcpp::Coordinate& coord, const mcpp::BlockType& type);
+
+        /**
+         * @brief Records an edit of every block in a cuboid.
+         * @param first One corner (inclusive).
+         * @param second Opposite corner (inclusive).
+         * @param type Block to place.
+         */
+        void setBlocks(const mcpp::Coordinate& first,
+                       const mcpp::Coordinate& second,
+                       const mcpp::BlockType& type);
+
+        /**
+         * @brief Returns the number of distinct cells waiting to be written.
+         * @return Pending cell count.
+         */
+        size_t getSize() const;
+
+        /**
+         * @brief Drops pending edits that would write the block already there.
+         *
+         * Cells @p current does not hold are kept. Since only the final type of a
+         * cell is sent, a cell whose edits end where it started is dropped
+         * as well.
+         *
+         * @param current Blocks around the surface before any pending edit.
+         * @return Number of cells dropped.
+         */
+        size_t dropUnchanged(const SurfaceSlab& current);
+
+        /**
+         * @brief Merges the pending edits into cuboids, in flush order.
+         * @return Cuboids covering every pending cell exactly once.
+         */
+        Vector<Cuboid> coalesce() const;
+
+        /**
+         * @brief Sends all pending edits and empties the buffer.
+         * @param world Backend receiving the writes.
+         * @return Number of server calls issued.
+         */
+        size_t flush(WorldBackend& world);
+
+        /**
+         * @brief Drops all pending edits without sending them.
+         */
+        void clear();
+
+        /**
+         * @brief Returns the issued, skipped and call counters.
+         * @return Statistics since construction.
+         */
+        Stats getStats() const;
+
+    private:
+        FlatMap<mcpp::Coordinate, mcpp::BlockType, BlockCoordHash> pending{};
+        Stats stats{};
+};
+
+#endif
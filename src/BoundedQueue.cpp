@@ -0,0 +1,57 @@
+#include "BoundedQueue.h"
+
+#include <utility>
+
+
+template<typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+    : capacity(capacity == 0 ? 1 : capacity)
+{}
+
+
+template<typename T>
+bool BoundedQueue<T>::push(T&& item) {
+
+    std::unique_lock<std::mutex> guard(lock);
+    notFull.wait(guard, [this]() { return closed || items.size() < capacity; });
+
+    bool accepted = !closed;
+    if (accepted) {
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+    }
+
+    return accepted;
+}
+
+
+template<typename T>
+std::optional<T> BoundedQueue<T>::pop() {
+
+    std::unique_lock<std::mutex> guard(lock);
+    notEmpty.wait(guard, [this]() { return closed || !items.empty(); });
+
+    std::optional<T> item{};
+    if (!items.empty()) {
+        item.emplace(std::move(items.front()));
+        items.pop_front();
+        notFull.notify_one();
+    }
+
+    return item;
+}
+
+
+template<typename T>
+void BoundedQueue<T>::close() {
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+    }
+
+    notFull.notify_all();
+    notEmpty.notify_all();
+
+    return;
+}
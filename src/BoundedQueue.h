@@ -0,0 +1,65 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * @brief A blocking FIFO with a fixed capacity, joining two pipeline stages.
+ *
+ * push() waits while the queue is full and pop() waits while it is empty,
+ * so a fast producer can run at most @c capacity items ahead of the
+ * consumer. close() wakes both sides: pending items can still be popped,
+ * but no new ones are accepted.
+ *
+ * @tparam T Type of the queued items (must be movable).
+ */
+template<typename T>
+class BoundedQueue {
+    public:
+        /**
+         * @brief Creates an empty, open queue.
+         * @param capacity Maximum number of queued items (minimum 1).
+         */
+        explicit BoundedQueue(size_t capacity);
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        /**
+         * @brief Appends an item, waiting for space if the queue is full.
+         * @param item The item to move into the queue.
+         * @return False if the queue was closed (the item is dropped).
+         */
+        bool push(T&& item);
+
+        /**
+         * @brief Removes the oldest item, waiting if the queue is empty.
+         * @return The item, or nothing once the queue is closed and drained.
+         */
+        std::optional<T> pop();
+
+        /**
+         * @brief Stops accepting items and wakes all waiting threads.
+         */
+        void close();
+
+    private:
+        std::deque<T> items{};
+        size_t capacity;
+        bool closed = false;
+
+        std::mutex lock;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+};
+
+
+
+#include "BoundedQueue.cpp"
+
+
+#endif
@@ -65,8 +65,8 @@ Cell Cell::neighborIn(Direction direction) const {
 }
 
 
-Vector<Cell> Cell::getNeighbors() const {
-    Vector<Cell> result;
+SmallVector<Cell, 4> Cell::getNeighbors() const {
+    SmallVector<Cell, 4> result;
 
     result.push_back(neighborIn(Direction::North));
     result.push_back(neighborIn(Direction::South));
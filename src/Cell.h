@@ -2,7 +2,7 @@
 #define CELL_H
 
 #include <mcpp/mcpp.h>
-#include "Vector.h"
+#include "SmallVector.h"
 #include <climits>
 
 /**
@@ -34,9 +34,9 @@ class Cell {
 
         /**
          * @brief Returns the four neighboring cells (N, S, E, W).
-         * @return Vector of neighboring cells.
+         * @return Inline vector of neighboring cells (no heap allocation).
          */
-        Vector<Cell> getNeighbors() const;
+        SmallVector<Cell, 4> getNeighbors() const;
 
         /**
          * @brief Comparison operator for min-heap ordering (used by A*).
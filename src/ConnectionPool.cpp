@@ -0,0 +1,179 @@
+#include "ConnectionPool.h"
+#include "McppBackend.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "Trace.h"
+
+
+ConnectionPool::ConnectionPool(size_t size, int tileSize,
+                               const std::string& address, int port)
+    : tileSize(tileSize < 1 ? 1 : tileSize) {
+
+    size_t count = (size == 0) ? 1 : size;
+
+    for (size_t i = 0; i <= count; ++i) {
+        owned.push_back(std::make_unique<McppBackend>(address, port));
+    }
+
+    // the last one is reserved for writes
+    for (size_t i = 0; i < count; ++i) {
+        connections.push_back(owned[i].get());
+    }
+    writeConnection = owned.back().get();
+}
+
+
+ConnectionPool::ConnectionPool(WorldBackend& world, size_t size, int tileSize)
+    : connections((size == 0) ? 1 : size, &world),
+      writeConnection(&world),
+      tileSize(tileSize < 1 ? 1 : tileSize)
+{}
+
+
+WorldBackend& ConnectionPool::writer() {
+    return *writeConnection;
+}
+
+
+size_t ConnectionPool::getSize() const {
+    return connections.size();
+}
+
+
+std::vector<ConnectionPool::Tile>
+ConnectionPool::splitRegion(int xLen, int zLen) const {
+
+    std::vector<Tile> tiles{};
+
+    for (int x = 0; x < xLen; x += tileSize) {
+        for (int z = 0; z < zLen; z += tileSize) {
+            tiles.push_back(Tile{x, z,
+                                 std::min(tileSize, xLen - x),
+                                 std::min(tileSize, zLen - z)});
+        }
+    }
+
+    return tiles;
+}
+
+
+template<typename Fetch>
+void ConnectionPool::forEachTile(const std::vector<Tile>& tiles, Fetch fetch) {
+
+    size_t workers = std::min(connections.size(), tiles.size());
+
+    std::exception_ptr failure = nullptr;
+    std::mutex failureLock;
+    std::vector<std::thread> threads{};
+
+    // a single tile gains nothing from a thread
+    if (workers <= 1) {
+        for (const Tile& tile : tiles) {
+            fetch(*connections.front(), tile);
+        }
+    }
+
+    for (size_t w = 0; w < workers && workers > 1; ++w) {
+        threads.emplace_back([&, w]() {
+            TRACE_THREAD("fetch", int(w));
+
+            try {
+                for (size_t t = w; t < tiles.size(); t += workers) {
+                    fetch(*connections[w], tiles[t]);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(failureLock);
+                if (failure == nullptr) {
+                    failure = std::current_exception();
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    if (failure != nullptr) {
+        std::rethrow_exception(failure);
+    }
+
+    return;
+}
+
+
+mcpp::HeightMap ConnectionPool::getHeights(const mcpp::Coordinate& loc1,
+                                           const mcpp::Coordinate& loc2) {
+
+    mcpp::Coordinate lo(std::min(loc1.x, loc2.x), 0, std::min(loc1.z, loc2.z));
+    mcpp::Coordinate hi(std::max(loc1.x, loc2.x), 0, std::max(loc1.z, loc2.z));
+
+    int xLen = hi.x - lo.x + 1;
+    int zLen = hi.z - lo.z + 1;
+
+    std::vector<Tile> tiles = splitRegion(xLen, zLen);
+
+    std::vector<int> heights(size_t(xLen) * zLen);
+
+    forEachTile(tiles, [&](WorldBackend& world, const Tile& tile) {
+        TRACE_SCOPE("getHeights");
+
+        mcpp::HeightMap part = world.getHeights(
+            mcpp::Coordinate(lo.x + tile.x, 0, lo.z + tile.z),
+            mcpp::Coordinate(lo.x + tile.x + tile.xLen - 1, 0,
+                             lo.z + tile.z + tile.zLen - 1));
+
+        // tiles cover disjoint parts of the output, so no locking is needed
+        for (int x = 0; x < tile.xLen; ++x) {
+            for (int z = 0; z < tile.zLen; ++z) {
+                heights[size_t(tile.x + x) * zLen + (tile.z + z)] = part.get(x, z);
+            }
+        }
+    });
+
+    return mcpp::HeightMap(lo, hi, heights);
+}
+
+
+mcpp::Chunk ConnectionPool::getBlocks(const mcpp::Coordinate& loc1,
+                                      const mcpp::Coordinate& loc2) {
+
+    mcpp::Coordinate lo(std::min(loc1.x, loc2.x), std::min(loc1.y, loc2.y),
+                        std::min(loc1.z, loc2.z));
+    mcpp::Coordinate hi(std::max(loc1.x, loc2.x), std::max(loc1.y, loc2.y),
+                        std::max(loc1.z, loc2.z));
+
+    int xLen = hi.x - lo.x + 1;
+    int yLen = hi.y - lo.y + 1;
+    int zLen = hi.z - lo.z + 1;
+
+    std::vector<Tile> tiles = splitRegion(xLen, zLen);
+
+    std::vector<mcpp::BlockType> blocks(size_t(xLen) * yLen * zLen);
+
+    forEachTile(tiles, [&](WorldBackend& world, const Tile& tile) {
+        TRACE_SCOPE("getBlocks");
+
+        mcpp::Chunk part = world.getBlocks(
+            mcpp::Coordinate(lo.x + tile.x, lo.y, lo.z + tile.z),
+            mcpp::Coordinate(lo.x + tile.x + tile.xLen - 1, hi.y,
+                             lo.z + tile.z + tile.zLen - 1));
+
+        // same layout as mcpp: index = y * xLen * zLen + x * zLen + z
+        for (int y = 0; y < yLen; ++y) {
+            for (int x = 0; x < tile.xLen; ++x) {
+                size_t row = (size_t(y) * xLen + (tile.x + x)) * zLen + tile.z;
+
+                for (int z = 0; z < tile.zLen; ++z) {
+                    blocks[row + z] = part.get(x, y, z);
+                }
+            }
+        }
+    });
+
+    return mcpp::Chunk(lo, hi, blocks);
+}
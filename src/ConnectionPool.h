@@ -0,0 +1,123 @@
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mcpp/mcpp.h>
+
+#include "WorldBackend.h"
+
+/**
+ * @brief A fixed set of world connections shared by the path builders.
+ *
+ * Connections are opened once, up front, instead of per connectPoints or
+ * buildPath call. Region fetches larger than one tile are split into
+ * tileSize x tileSize columns, downloaded on all connections in parallel
+ * (one thread per connection, each working through its own tiles) and
+ * reassembled into a single HeightMap/Chunk with the same layout mcpp
+ * returns. Single-tile fetches run on the calling thread.
+ *
+ * Writes go through a separate connection, so one thread may stream
+ * writes while another fetches. A single MinecraftConnection is not
+ * thread safe: at most one thread may fetch and one may write at a time.
+ *
+ * The pool either opens McppBackend connections to a server or shares one
+ * thread-safe backend (e.g. a SimulatedWorld) across all of its slots.
+ */
+class ConnectionPool {
+    public:
+        static constexpr size_t DEFAULT_SIZE = 4;
+        static constexpr int DEFAULT_TILE_SIZE = 64;
+
+        /**
+         * @brief Opens @p size fetch connections and one write connection.
+         * @param size Number of fetch connections (at least one is opened).
+         * @param tileSize Side length of the fetch tiles along x and z.
+         * @param address Server address.
+         * @param port Server port.
+         */
+        explicit ConnectionPool(size_t size = DEFAULT_SIZE,
+                                int tileSize = DEFAULT_TILE_SIZE,
+                                const std::string& address = "localhost",
+                                int port = 4711);
+
+        /**
+         * @brief Uses @p world for every fetch and write slot.
+         * @param world Thread-safe backend; must outlive the pool.
+         * @param size Number of parallel fetch slots (minimum one).
+         * @param tileSize Side length of the fetch tiles along x and z.
+         */
+        explicit ConnectionPool(WorldBackend& world,
+                                size_t size = DEFAULT_SIZE,
+                                int tileSize = DEFAULT_TILE_SIZE);
+
+        ConnectionPool(const ConnectionPool&) = delete;
+        ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+        /**
+         * @brief Returns the connection used for writes.
+         * @return The dedicated write connection.
+         */
+        WorldBackend& writer();
+
+        /**
+         * @brief Fetches the height map of a region, tiled over the pool.
+         * @param loc1 One corner (y ignored).
+         * @param loc2 Opposite corner (y ignored).
+         * @return Height map equivalent to a single getHeights call.
+         */
+        mcpp::HeightMap getHeights(const mcpp::Coordinate& loc1,
+                                   const mcpp::Coordinate& loc2);
+
+        /**
+         * @brief Fetches the blocks of a region, tiled over the pool.
+         * @param loc1 One corner.
+         * @param loc2 Opposite corner.
+         * @return Chunk equivalent to a single getBlocks call.
+         */
+        mcpp::Chunk getBlocks(const mcpp::Coordinate& loc1,
+                              const mcpp::Coordinate& loc2);
+
+        /**
+         * @brief Returns the number of fetch connections.
+         * @return Pool size, not counting the write connection.
+         */
+        size_t getSize() const;
+
+    private:
+        /**
+         * @brief One x-z column of a split fetch, in region-local offsets.
+         */
+        struct Tile {
+            int x;
+            int z;
+            int xLen;
+            int zLen;
+        };
+
+        /**
+         * @brief Splits an xLen x zLen region into tiles.
+         */
+        std::vector<Tile> splitRegion(int xLen, int zLen) const;
+
+        /**
+         * @brief Runs @p fetch(connection, tile) for every tile, spreading
+         *   the tiles round-robin over the connections.
+         *
+         * Rethrows the first exception raised by any worker after all of
+         * them have finished.
+         */
+        template<typename Fetch>
+        void forEachTile(const std::vector<Tile>& tiles, Fetch fetch);
+
+        // backends opened by the pool; empty when sharing an external one
+        std::vector<std::unique_ptr<WorldBackend>> owned{};
+
+        std::vector<WorldBackend*> connections{};
+        WorldBackend* writeConnection = nullptr;
+        int tileSize;
+};
+
+#endif
@@ -0,0 +1,453 @@
+#include "FlatMap.h"
+
+
+
+/* ------------------------------------------
+ * ---------------- Group -------------------
+ * ------------------------------------------ */
+
+#if defined(__SSE2__)
+
+template<typename K, typename V, typename Hash, typename Alloc>
+FlatMap<K, V, Hash, Alloc>::Group::Group(const int8_t* pos)
+    : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+{}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+uint32_t FlatMap<K, V, Hash, Alloc>::Group::match(int8_t tag) const {
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl)));
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+uint32_t FlatMap<K, V, Hash, Alloc>::Group::matchEmpty() const {
+    return match(EMPTY);
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+uint32_t FlatMap<K, V, Hash, Alloc>::Group::matchEmptyOrDeleted() const {
+    // EMPTY and DELETED are the only control bytes below -1
+    return uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+}
+
+#else
+
+template<typename K, typename V, typename Hash, typename Alloc>
+FlatMap<K, V, Hash, Alloc>::Group::Group(const int8_t* pos) {
+    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+        ctrl[i] = pos[i];
+    }
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+uint32_t FlatMap<K, V, Hash, Alloc>::Group::match(int8_t tag) const {
+
+    uint32_t mask = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+        if (ctrl[i] == tag) {
+            mask |= uint32_t(1) << i;
+        }
+    }
+
+    return mask;
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+uint32_t FlatMap<K, V, Hash, Alloc>::Group::matchEmpty() const {
+    return match(EMPTY);
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+uint32_t FlatMap<K, V, Hash, Alloc>::Group::matchEmptyOrDeleted() const {
+
+    uint32_t mask = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+        if (ctrl[i] < -1) {
+            mask |= uint32_t(1) << i;
+        }
+    }
+
+    return mask;
+}
+
+#endif
+
+
+/* ------------------------------------------
+ * --------------- Helpers ------------------
+ * ------------------------------------------ */
+
+template<typename K, typename V, typename Hash, typename Alloc>
+size_t FlatMap<K, V, Hash, Alloc>::maxLoad(size_t cap) {
+    return cap - cap / 8;
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+void FlatMap<K, V, Hash, Alloc>::setCtrl(size_t idx, int8_t value) {
+
+    int8_t* bytes = ctrl.begin();
+
+    bytes[idx] = value;
+    if (idx < GROUP_WIDTH) {
+        bytes[capacity + idx] = value;
+    }
+
+    return;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+size_t FlatMap<K, V, Hash, Alloc>::findIndex(const K& key, size_t hash) const {
+
+    const int8_t* bytes = ctrl.begin();
+    const Entry* entries = slots.begin();
+
+    const size_t mask = capacity - 1;
+    const int8_t tag = int8_t(hash & 0x7F);
+
+    size_t pos = (hash >> 7) & mask;
+    size_t step = 0;
+
+    size_t found = capacity;
+    bool done = false;
+
+    // triangular probing over groups visits every group exactly once
+    // because the capacity is a power of two
+    while (!done) {
+        Group group(bytes + pos);
+
+        uint32_t candidates = group.match(tag);
+        while (candidates != 0 && found == capacity) {
+            size_t idx = (pos + lowestBit(candidates)) & mask;
+            if (entries[idx].key == key) {
+                found = idx;
+            }
+            candidates &= candidates - 1;
+        }
+
+        if (found != capacity || group.matchEmpty() != 0 || step >= capacity) {
+            done = true;
+        }
+        else {
+            step += GROUP_WIDTH;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    return found;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+size_t FlatMap<K, V, Hash, Alloc>::findInsertSlot(size_t hash) const {
+
+    const int8_t* bytes = ctrl.begin();
+    const size_t mask = capacity - 1;
+
+    size_t pos = (hash >> 7) & mask;
+    size_t step = 0;
+
+    uint32_t free = Group(bytes + pos).matchEmptyOrDeleted();
+    while (free == 0) {
+        step += GROUP_WIDTH;
+        pos = (pos + step) & mask;
+        free = Group(bytes + pos).matchEmptyOrDeleted();
+    }
+
+    return (pos + lowestBit(free)) & mask;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+void FlatMap<K, V, Hash, Alloc>::rehash(size_t newCap) {
+
+    Vector<int8_t, CtrlAlloc> oldCtrl(newCap + GROUP_WIDTH, CtrlAlloc(alloc),
+                                      AllocStats::FLAT_MAP);
+    Vector<Entry, EntryAlloc> oldSlots(newCap, EntryAlloc(alloc), AllocStats::FLAT_MAP);
+
+    // swap the fresh tables in; the locals now hold the old ones
+    ctrl.swap(oldCtrl);
+    slots.swap(oldSlots);
+
+    size_t oldCap = capacity;
+    capacity = newCap;
+
+    if (oldCap > 0) {
+        AllocStats::onReallocate(AllocStats::FLAT_MAP);
+    }
+    growthLeft = maxLoad(newCap) - count;
+
+    for (int8_t& byte : ctrl) {
+        byte = EMPTY;
+    }
+
+    // entries are moved, never copied, into their new slots
+    for (size_t i = 0; i < oldCap; ++i) {
+        if (oldCtrl[i] >= 0) {
+            size_t hash = hasher(oldSlots[i].key);
+            size_t idx = findInsertSlot(hash);
+
+            setCtrl(idx, int8_t(hash & 0x7F));
+            slots.begin()[idx] = std::move(oldSlots[i]);
+        }
+    }
+
+    return;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+void FlatMap<K, V, Hash, Alloc>::makeRoom() {
+
+    // mostly tombstones: rebuild in place, otherwise double
+    if (count * 2 < maxLoad(capacity)) {
+        rehash(capacity);
+    }
+    else {
+        rehash(capacity * 2);
+    }
+
+    return;
+}
+
+
+/* ------------------------------------------
+ * ---------------- Public ------------------
+ * ------------------------------------------ */
+
+template<typename K, typename V, typename Hash, typename Alloc>
+FlatMap<K, V, Hash, Alloc>::FlatMap(int cap, const Alloc& alloc)
+    : alloc(alloc), ctrl(CtrlAlloc(alloc), AllocStats::FLAT_MAP),
+      slots(EntryAlloc(alloc), AllocStats::FLAT_MAP)
+{
+
+    size_t newCap = MINIMUM_CAP;
+    while (cap > 0 && newCap < size_t(cap)) {
+        newCap *= 2;
+    }
+
+    capacity = 0;
+    rehash(newCap);
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+bool FlatMap<K, V, Hash, Alloc>::contains(const K& key) const {
+
+    return findIndex(key, hasher(key)) != capacity;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+V* FlatMap<K, V, Hash, Alloc>::find(const K& key) {
+
+    size_t idx = findIndex(key, hasher(key));
+
+    return idx != capacity ? &slots.begin()[idx].value : nullptr;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+const V* FlatMap<K, V, Hash, Alloc>::find(const K& key) const {
+
+    size_t idx = findIndex(key, hasher(key));
+
+    return idx != capacity ? &slots.begin()[idx].value : nullptr;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename... Args>
+std::pair<V*, bool> FlatMap<K, V, Hash, Alloc>::try_emplace(const K& key, Args&&... args) {
+
+    size_t hash = hasher(key);
+    size_t idx = findIndex(key, hash);
+    bool inserted = false;
+
+    if (idx == capacity) {
+        idx = findInsertSlot(hash);
+
+        // reusing a tombstone does not use up any growth
+        if (growthLeft == 0 && ctrl.begin()[idx] == EMPTY) {
+            makeRoom();
+            idx = findInsertSlot(hash);
+        }
+
+        if (ctrl.begin()[idx] == EMPTY) {
+            --growthLeft;
+        }
+
+        setCtrl(idx, int8_t(hash & 0x7F));
+
+        Entry& entry = slots.begin()[idx];
+        entry.key = key;
+        entry.value = V(std::forward<Args>(args)...);
+        ++count;
+
+        inserted = true;
+    }
+
+    return {&slots.begin()[idx].value, inserted};
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+std::pair<V*, bool> FlatMap<K, V, Hash, Alloc>::insert_or_assign(const K& key, const V& value) {
+
+    std::pair<V*, bool> result = try_emplace(key, value);
+
+    if (!result.second) {
+        *result.first = value;
+    }
+
+    return result;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+bool FlatMap<K, V, Hash, Alloc>::erase(const K& key) {
+
+    size_t idx = findIndex(key, hasher(key));
+    bool erased = idx != capacity;
+
+    if (erased) {
+        setCtrl(idx, DELETED);
+        slots.begin()[idx] = Entry();
+        --count;
+    }
+
+    return erased;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+void FlatMap<K, V, Hash, Alloc>::reserve(int n) {
+
+    size_t newCap = capacity;
+    while (n > 0 && maxLoad(newCap) < size_t(n)) {
+        newCap *= 2;
+    }
+
+    if (newCap != capacity) {
+        rehash(newCap);
+    }
+
+    return;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+int FlatMap<K, V, Hash, Alloc>::getSize() const {
+    return int(count);
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+void FlatMap<K, V, Hash, Alloc>::clear() {
+
+    int8_t* bytes = ctrl.begin();
+    Entry* entries = slots.begin();
+
+    for (size_t i = 0; i < capacity; ++i) {
+        if (bytes[i] >= 0) {
+            entries[i] = Entry();
+        }
+    }
+
+    for (int8_t& byte : ctrl) {
+        byte = EMPTY;
+    }
+
+    count = 0;
+    growthLeft = maxLoad(capacity);
+
+    return;
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+V& FlatMap<K, V, Hash, Alloc>::operator[](const K& key) {
+
+    return *try_emplace(key).first;
+
+}
+
+
+template<typename K, typename V, typename Hash, typename Alloc>
+typename FlatMap<K, V, Hash, Alloc>::iterator FlatMap<K, V, Hash, Alloc>::begin() {
+    return iterator(ctrl.begin(), slots.begin(), 0, capacity);
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+typename FlatMap<K, V, Hash, Alloc>::iterator FlatMap<K, V, Hash, Alloc>::end() {
+    return iterator(ctrl.begin(), slots.begin(), capacity, capacity);
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+typename FlatMap<K, V, Hash, Alloc>::const_iterator FlatMap<K, V, Hash, Alloc>::begin() const {
+    return const_iterator(ctrl.begin(), slots.begin(), 0, capacity);
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+typename FlatMap<K, V, Hash, Alloc>::const_iterator FlatMap<K, V, Hash, Alloc>::end() const {
+    return const_iterator(ctrl.begin(), slots.begin(), capacity, capacity);
+}
+
+
+/* ------------------------------------------
+ * --------------- Iterator -----------------
+ * ------------------------------------------ */
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename E>
+FlatMap<K, V, Hash, Alloc>::Iterator<E>::Iterator(const int8_t* ctrl, E* slots,
+                                                  size_t idx, size_t last)
+    : ctrl(ctrl), slots(slots), idx(idx), last(last)
+{
+    skipFree();
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename E>
+void FlatMap<K, V, Hash, Alloc>::Iterator<E>::skipFree() {
+
+    while (idx != last && ctrl[idx] < 0) {
+        ++idx;
+    }
+
+    return;
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename E>
+E& FlatMap<K, V, Hash, Alloc>::Iterator<E>::operator*() const {
+    return slots[idx];
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename E>
+E* FlatMap<K, V, Hash, Alloc>::Iterator<E>::operator->() const {
+    return slots + idx;
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename E>
+typename FlatMap<K, V, Hash, Alloc>::template Iterator<E>&
+FlatMap<K, V, Hash, Alloc>::Iterator<E>::operator++() {
+
+    ++idx;
+    skipFree();
+
+    return *this;
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename E>
+bool FlatMap<K, V, Hash, Alloc>::Iterator<E>::operator==(const Iterator& other) const {
+    return idx == other.idx;
+}
+
+template<typename K, typename V, typename Hash, typename Alloc>
+template<typename E>
+bool FlatMap<K, V, Hash, Alloc>::Iterator<E>::operator!=(const Iterator& other) const {
+    return idx != other.idx;
+}
@@ -0,0 +1,268 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Hash.h"
+#include "Vector.h"
+
+
+/**
+ * @brief A high-performance open-addressing hash map (Swiss-table style).
+ *
+ * Keeps one control byte per slot in a separate array: either EMPTY,
+ * DELETED, or the low 7 bits of the key's hash. Lookups scan the control
+ * bytes 16 at a time (with SSE2 when available) and only compare keys whose
+ * 7-bit tag matches, so most misses never touch the slot array. The
+ * capacity is a power of two and positions are taken with a mask.
+ *
+ * Offers the same interface as Map. Grows at 7/8 load; erased slots become
+ * tombstones that are purged on the next rehash.
+ *
+ * @tparam K Type of the key.
+ * @tparam V Type of the value.
+ * @tparam Hash Hash functor; should mix all bits well (see CoordHash).
+ * @tparam Alloc Allocator for the tables (rebound to the internal types).
+ */
+template<typename K, typename V, typename Hash = std::hash<K>,
+         typename Alloc = std::allocator<std::pair<const K, V>>>
+class FlatMap {
+    public:
+        /**
+         * @brief A key-value pair stored in the slot array.
+         *
+         * Exposed through iteration; the key must not be modified.
+         */
+        struct Entry {
+            K key{};
+            V value{};
+        };
+
+    private:
+        static constexpr size_t GROUP_WIDTH = 16;
+        static constexpr size_t MINIMUM_CAP = GROUP_WIDTH;
+
+        static constexpr int8_t EMPTY = -128;
+        static constexpr int8_t DELETED = -2;
+
+        /**
+         * @brief A window of GROUP_WIDTH control bytes matched in parallel.
+         *
+         * Each match returns a bitmask with bit i set when byte i matches.
+         */
+        class Group {
+            public:
+                /**
+                 * @brief Loads GROUP_WIDTH control bytes starting at @p pos.
+                 * @param pos First control byte (need not be aligned).
+                 */
+                explicit Group(const int8_t* pos);
+
+                uint32_t match(int8_t tag) const;
+                uint32_t matchEmpty() const;
+                uint32_t matchEmptyOrDeleted() const;
+
+            private:
+#if defined(__SSE2__)
+                __m128i ctrl;
+#else
+                int8_t ctrl[GROUP_WIDTH];
+#endif
+        };
+
+        using CtrlAlloc = typename std::allocator_traits<Alloc>::
+            template rebind_alloc<int8_t>;
+        using EntryAlloc = typename std::allocator_traits<Alloc>::
+            template rebind_alloc<Entry>;
+
+        Alloc alloc;
+        Hash hasher{};
+
+        // capacity + GROUP_WIDTH bytes; the tail mirrors the first
+        // GROUP_WIDTH bytes so a group can be loaded at any position
+        Vector<int8_t, CtrlAlloc> ctrl;
+        Vector<Entry, EntryAlloc> slots;
+
+        size_t capacity = 0;
+        size_t count = 0;
+        size_t growthLeft = 0;
+
+        /**
+         * @brief Maximum number of entries before a rehash is needed (7/8).
+         */
+        static size_t maxLoad(size_t cap);
+
+        /**
+         * @brief Sets a control byte and its mirrored copy, if any.
+         * @param idx Slot index.
+         * @param value New control byte.
+         */
+        void setCtrl(size_t idx, int8_t value);
+
+        /**
+         * @brief Probes for @p key.
+         * @param key The key to search for.
+         * @param hash Precomputed hash of @p key.
+         * @return Slot index of the key, or capacity if absent.
+         */
+        size_t findIndex(const K& key, size_t hash) const;
+
+        /**
+         * @brief Finds the first empty or deleted slot on @p hash's probe path.
+         * @param hash Hash of the key to insert.
+         * @return Slot index to insert into.
+         */
+        size_t findInsertSlot(size_t hash) const;
+
+        /**
+         * @brief Rebuilds the table with @p newCap slots, dropping tombstones.
+         * @param newCap New capacity (power of two, >= MINIMUM_CAP).
+         */
+        void rehash(size_t newCap);
+
+        /**
+         * @brief Makes room for one more entry, growing or purging tombstones.
+         */
+        void makeRoom();
+
+    public:
+        using allocator_type = Alloc;
+
+        /**
+         * @brief Forward iterator over the stored entries.
+         * @tparam E Entry or const Entry.
+         */
+        template<typename E>
+        class Iterator {
+            public:
+                /**
+                 * @brief Creates an iterator at @p idx, skipping free slots.
+                 * @param ctrl Control bytes.
+                 * @param slots Slot array.
+                 * @param idx Current slot index.
+                 * @param last Capacity of the table.
+                 */
+                Iterator(const int8_t* ctrl, E* slots, size_t idx, size_t last);
+
+                E& operator*() const;
+                E* operator->() const;
+                Iterator& operator++();
+                bool operator==(const Iterator& other) const;
+                bool operator!=(const Iterator& other) const;
+
+            private:
+                /**
+                 * @brief Advances to the next full slot (or the end).
+                 */
+                void skipFree();
+
+                const int8_t* ctrl;
+                E* slots;
+                size_t idx;
+                size_t last;
+        };
+
+        using iterator = Iterator<Entry>;
+        using const_iterator = Iterator<const Entry>;
+
+        /**
+         * @brief Constructs a map with an initial capacity.
+         * @param cap Initial slot count; rounded up to a power of two, minimum 16.
+         * @param alloc Allocator for the table storage.
+         */
+        FlatMap(int cap = 8, const Alloc& alloc = Alloc());
+
+        /**
+         * @brief Checks whether the map contains a given key.
+         * @param key The key to search for.
+         * @return True if the key exists, false otherwise.
+         */
+        bool contains(const K& key) const;
+
+        /**
+         * @brief Looks up a key without inserting it.
+         * @param key The key to search for.
+         * @return Pointer to the value, or nullptr if the key is absent.
+         *   Valid until the next insertion or erase.
+         */
+        V* find(const K& key);
+
+        /**
+         * @brief Looks up a key without inserting it (const).
+         * @param key The key to search for.
+         * @return Pointer to the value, or nullptr if the key is absent.
+         */
+        const V* find(const K& key) const;
+
+        /**
+         * @brief Inserts @p key with a value built from @p args, if absent.
+         * @param key The key to look up or insert.
+         * @param args Arguments forwarded to V's constructor on insertion.
+         * @return {pointer to the value, true if it was inserted}.
+         */
+        template<typename... Args>
+        std::pair<V*, bool> try_emplace(const K& key, Args&&... args);
+
+        /**
+         * @brief Inserts @p key or overwrites its value.
+         * @param key The key to insert or update.
+         * @param value The value to store.
+         * @return {pointer to the value, true if it was inserted}.
+         */
+        std::pair<V*, bool> insert_or_assign(const K& key, const V& value);
+
+        /**
+         * @brief Removes a key, leaving a tombstone.
+         * @param key The key to remove.
+         * @return True if the key was present.
+         */
+        bool erase(const K& key);
+
+        /**
+         * @brief Grows the table so @p n entries fit without a rehash.
+         * @param n Number of entries to make room for.
+         */
+        void reserve(int n);
+
+        /**
+         * @brief Returns the number of entries.
+         * @return The number of keys stored.
+         */
+        int getSize() const;
+
+        /**
+         * @brief Removes all entries. Keeps the table capacity.
+         */
+        void clear();
+
+        /**
+         * @brief Accesses the value associated with a key.
+         *
+         * If the key does not exist, it is inserted with a default value.
+         *
+         * @param key The key to look up or insert.
+         * @return Reference to the value associated with the key.
+         */
+        V& operator[](const K& key);
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+};
+
+
+
+#include "FlatMap.cpp"
+
+
+#endif
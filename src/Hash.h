@@ -0,0 +1,97 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mcpp/mcpp.h>
+
+/**
+ * @brief 64-bit finalizer (MurmurHash3 fmix64).
+ *
+ * Every input bit affects every output bit, so both the low bits (used for
+ * the probe position) and the high bits (used for control bytes) of the
+ * result are well distributed, even for small, clustered coordinates.
+ *
+ * @param h Value to mix.
+ * @return Mixed value.
+ */
+inline uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+
+    return h;
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero word.
+ *
+ * Used to walk match masks and bitmap rows one set bit at a time.
+ *
+ * @param bits Word to scan; must not be zero.
+ * @return Position of the lowest set bit, 0 for the least significant.
+ */
+inline int lowestBit(uint64_t bits) {
+
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int bit = 0;
+    while ((bits & 1u) == 0) {
+        bits >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Strong hash for 2D coordinates, intended for FlatMap.
+ *
+ * Packs (x, z) into one 64-bit word and runs it through mix64().
+ */
+struct CoordHash {
+    size_t operator()(const mcpp::Coordinate2D& c) const noexcept {
+
+        uint64_t packed = (uint64_t(uint32_t(c.x)) << 32) | uint32_t(c.z);
+
+        return static_cast<size_t>(mix64(packed));
+    }
+};
+
+/**
+ * @brief Simple hash for 2D coordinates, used by Map and as the default
+ * for std containers keyed by mcpp::Coordinate2D.
+ */
+namespace std {
+    template<>
+    struct hash<mcpp::Coordinate2D> {
+
+        size_t operator()(const mcpp::Coordinate2D& c) const noexcept {
+
+            uint64_t x = static_cast<uint32_t>(c.x);
+            uint64_t z = static_cast<uint32_t>(c.z);
+            uint64_t h = x * 0x9E3779B185EBCA87ull ^
+                (z + 0x9E3779B185EBCA87ull + (x<<6) + (x>>2));
+                
+            return static_cast<size_t>(h);
+        }
+    };
+}
+
+/**
+ * @brief Strong hash for 3D block coordinates, intended for FlatMap.
+ */
+struct BlockCoordHash {
+    size_t operator()(const mcpp::Coordinate& c) const noexcept {
+
+        uint64_t packed = (uint64_t(uint32_t(c.x)) << 32) | uint32_t(c.z);
+
+        return static_cast<size_t>(mix64(mix64(packed) ^ uint32_t(c.y)));
+    }
+};
+
+#endif
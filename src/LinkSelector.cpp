@@ -0,0 +1,338 @@
+#include "LinkSelector.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "Trace.h"
+
+
+/* ------------------------------------------
+ * -------------- Heap entries --------------
+ * ------------------------------------------ */
+
+bool LinkSelector::Candidate::operator<(const Candidate& other) const {
+
+    bool isLess = false;
+
+    if (dist != other.dist) {
+        isLess = dist < other.dist;
+    }
+    else if (conn != other.conn) {
+        isLess = conn < other.conn;
+    }
+    else {
+        isLess = unconn < other.unconn;
+    }
+
+    return isLess;
+}
+
+
+bool LinkSelector::Candidate::operator>(const Candidate& other) const {
+    return other < *this;
+}
+
+
+bool LinkSelector::Farthest::operator<(const Farthest& other) const {
+    // reversed, so the min-heap keeps the largest distance on top
+    return dist > other.dist;
+}
+
+
+bool LinkSelector::Farthest::operator>(const Farthest& other) const {
+    return other < *this;
+}
+
+
+/* ------------------------------------------
+ * ---------------- Private -----------------
+ * ------------------------------------------ */
+
+mcpp::Coordinate2D LinkSelector::cellOf(const mcpp::Coordinate& point) {
+    return mcpp::Coordinate2D(point.x >> CELL_SHIFT, point.z >> CELL_SHIFT);
+}
+
+
+void LinkSelector::addToGrid(Grid& grid, const mcpp::Coordinate& point, int id) {
+
+    mcpp::Coordinate2D cell = cellOf(point);
+
+    if (grid.index.getSize() == 0) {
+        grid.minCell = cell;
+        grid.maxCell = cell;
+    }
+    else {
+        grid.minCell.x = std::min(grid.minCell.x, cell.x);
+        grid.minCell.z = std::min(grid.minCell.z, cell.z);
+        grid.maxCell.x = std::max(grid.maxCell.x, cell.x);
+        grid.maxCell.z = std::max(grid.maxCell.z, cell.z);
+    }
+
+    std::pair<int*, bool> slot = grid.index.try_emplace(cell, int(grid.cells.size()));
+    if (slot.second) {
+        grid.cells.push_back(Vector<int>());
+    }
+
+    grid.cells[*slot.first].push_back(id);
+
+    return;
+}
+
+
+bool LinkSelector::collectRing(const Grid& grid, const mcpp::Coordinate2D& center,
+                               int ring, Vector<int>& ids) {
+
+    int reach = 0;
+    if (grid.index.getSize() > 0) {
+        reach = std::max({std::abs(center.x - grid.minCell.x),
+                          std::abs(center.x - grid.maxCell.x),
+                          std::abs(center.z - grid.minCell.z),
+                          std::abs(center.z - grid.maxCell.z)});
+    }
+
+    bool isInside = grid.index.getSize() > 0 && ring <= reach;
+
+    if (isInside) {
+        // only the part of the ring that overlaps the occupied cells
+        int xFrom = std::max(center.x - ring, grid.minCell.x);
+        int xTo = std::min(center.x + ring, grid.maxCell.x);
+
+        for (int x = xFrom; x <= xTo; ++x) {
+            bool isEdgeRow = std::abs(x - center.x) == ring;
+
+            // inner rows only touch the ring at its two z ends
+            int zStep = isEdgeRow ? 1 : 2 * ring;
+            int zFrom = center.z - ring;
+            if (isEdgeRow) {
+                zFrom = std::max(zFrom, grid.minCell.z);
+            }
+
+            for (int z = zFrom; z <= center.z + ring && z <= grid.maxCell.z; z += zStep) {
+                const int* cell = (z >= grid.minCell.z)
+                    ? grid.index.find(mcpp::Coordinate2D(x, z)) : nullptr;
+
+                if (cell != nullptr) {
+                    for (int id : grid.cells[*cell]) {
+                        ids.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+
+    return isInside;
+}
+
+
+int LinkSelector::distance(const mcpp::Coordinate& first,
+                           const mcpp::Coordinate& second) {
+
+    // same metric as getManhattanDist
+    return std::abs(first.x - second.x) + std::abs(first.y - second.y) +
+           std::abs(first.z - second.z);
+}
+
+
+int LinkSelector::ringDistance(int ring) {
+    // points in ring r are at least r - 1 whole cells away along x or z
+    return (ring == 0) ? 0 : (ring - 1) * CELL_SIZE + 1;
+}
+
+
+void LinkSelector::setBest(int id, int dist, int conn) {
+
+    if (bestConn[id] == -1) {
+        --unlinkedCount;
+    }
+
+    bestDist[id] = dist;
+    bestConn[id] = conn;
+
+    nearest.insert(Candidate{dist, conn, id});
+    farthest.insert(Farthest{dist, id});
+
+    return;
+}
+
+
+void LinkSelector::findNearest(int id) {
+
+    const mcpp::Coordinate& point = unconnectedPts[id];
+    mcpp::Coordinate2D center = cellOf(point);
+
+    int dist = INT_MAX;
+    int conn = -1;
+
+    Vector<int> ids{};
+    bool hasMore = true;
+
+    // a ring is only worth visiting while it may hold an equal distance,
+    // because an equal distance at a lower index still wins
+    for (int ring = 0; hasMore && ringDistance(ring) <= dist; ++ring) {
+        ids.clear();
+        hasMore = collectRing(connectedGrid, center, ring, ids);
+
+        for (int candidate : ids) {
+            int candidateDist = distance(point, connectedPts[candidate]);
+
+            if (candidateDist < dist || (candidateDist == dist && candidate < conn)) {
+                dist = candidateDist;
+                conn = candidate;
+            }
+        }
+    }
+
+    if (conn != -1) {
+        setBest(id, dist, conn);
+    }
+
+    return;
+}
+
+
+int LinkSelector::farthestBest() {
+
+    bool isStale = true;
+    while (isStale && !farthest.isEmpty()) {
+        const Farthest& top = farthest.top();
+
+        isStale = !isLive[top.unconn] || bestDist[top.unconn] != top.dist;
+        if (isStale) {
+            farthest.pop();
+        }
+    }
+
+    return farthest.isEmpty() ? 0 : farthest.top().dist;
+}
+
+
+/* ------------------------------------------
+ * ---------------- Public ------------------
+ * ------------------------------------------ */
+
+LinkSelector::LinkSelector(const std::vector<mcpp::Coordinate>& connected,
+                           const std::vector<mcpp::Coordinate>& unconnected)
+    : bestDist(unconnected.size()),
+      bestConn(unconnected.size()),
+      isLive(unconnected.size()),
+      liveCount(unconnected.size()),
+      unlinkedCount(unconnected.size()) {
+
+    for (const mcpp::Coordinate& point : connected) {
+        addToGrid(connectedGrid, point, int(connectedPts.getSize()));
+        connectedPts.push_back(point);
+    }
+
+    for (size_t i = 0; i < unconnected.size(); ++i) {
+        unconnectedPts.push_back(unconnected[i]);
+        addToGrid(unconnectedGrid, unconnected[i], int(i));
+
+        bestDist[i] = INT_MAX;
+        bestConn[i] = -1;
+        isLive[i] = 1;
+    }
+
+    for (size_t i = 0; i < unconnected.size(); ++i) {
+        findNearest(int(i));
+    }
+}
+
+
+bool LinkSelector::isEmpty() const {
+    return liveCount == 0;
+}
+
+
+std::pair<mcpp::Coordinate, mcpp::Coordinate> LinkSelector::next() {
+
+    TRACE_SCOPE("LinkSelector::next");
+
+    bool isStale = true;
+    while (isStale && !nearest.isEmpty()) {
+        const Candidate& top = nearest.top();
+
+        isStale = !isLive[top.unconn] || bestDist[top.unconn] != top.dist ||
+                  bestConn[top.unconn] != top.conn;
+        if (isStale) {
+            nearest.pop();
+        }
+    }
+
+    if (nearest.isEmpty()) {
+        throw std::runtime_error("No link available");
+    }
+
+    const Candidate& best = nearest.top();
+
+    return std::make_pair(unconnectedPts[best.unconn], connectedPts[best.conn]);
+}
+
+
+void LinkSelector::addConnected(const mcpp::Coordinate& point) {
+
+    int conn = int(connectedPts.getSize());
+    connectedPts.push_back(point);
+    addToGrid(connectedGrid, point, conn);
+
+    // points with no connected neighbor yet must all be visited
+    int reach = (unlinkedCount > 0) ? INT_MAX : farthestBest();
+
+    mcpp::Coordinate2D center = cellOf(point);
+    Vector<int> ids{};
+    bool hasMore = true;
+
+    // the newest point loses ties, so only strictly closer links change
+    for (int ring = 0; hasMore && ringDistance(ring) < reach; ++ring) {
+        ids.clear();
+        hasMore = collectRing(unconnectedGrid, center, ring, ids);
+
+        for (int id : ids) {
+            if (isLive[id]) {
+                int dist = distance(point, unconnectedPts[id]);
+
+                if (dist < bestDist[id]) {
+                    setBest(id, dist, conn);
+                }
+            }
+        }
+    }
+
+    return;
+}
+
+
+void LinkSelector::removeUnconnected(const mcpp::Coordinate& point) {
+
+    const int* cell = unconnectedGrid.index.find(cellOf(point));
+
+    if (cell != nullptr) {
+        for (int id : unconnectedGrid.cells[*cell]) {
+            if (isLive[id] && unconnectedPts[id] == point) {
+                isLive[id] = 0;
+                --liveCount;
+
+                if (bestConn[id] == -1) {
+                    --unlinkedCount;
+                }
+            }
+        }
+    }
+
+    return;
+}
+
+
+std::vector<mcpp::Coordinate> LinkSelector::remaining() const {
+
+    std::vector<mcpp::Coordinate> points{};
+
+    for (size_t i = 0; i < unconnectedPts.getSize(); ++i) {
+        if (isLive[i]) {
+            points.push_back(unconnectedPts[i]);
+        }
+    }
+
+    return points;
+}
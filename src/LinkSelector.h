@@ -0,0 +1,170 @@
+#ifndef LINK_SELECTOR_H
+#define LINK_SELECTOR_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <mcpp/mcpp.h>
+
+#include "Vector.h"
+#include "FlatMap.h"
+#include "Hash.h"
+#include "PriorityQueue.h"
+
+/**
+ * @brief Picks the closest connected/unconnected pair, one link at a time.
+ *
+ * Every unconnected point remembers its nearest connected point, and the
+ * candidates sit in a min-heap ordered by (distance, connected index,
+ * unconnected index). That is exactly the pair the nested scan of
+ * closestLink() settles on, since the scan only replaces its choice on a
+ * strictly smaller distance. When a point joins the connected set, only
+ * the unconnected points it can be closer to are revisited, found through
+ * a uniform grid over (x, z).
+ *
+ * Heap entries are never updated in place: a newer, closer entry is pushed
+ * and the old one is skipped once it reaches the top.
+ */
+class LinkSelector {
+    public:
+        /**
+         * @brief Indexes both point sets.
+         * @param connected Points already linked, in connectPoints order.
+         * @param unconnected Points still unlinked, in connectPoints order.
+         */
+        LinkSelector(const std::vector<mcpp::Coordinate>& connected,
+                     const std::vector<mcpp::Coordinate>& unconnected);
+
+        /**
+         * @brief Checks whether any unconnected point is left.
+         * @return True if every unconnected point was removed.
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief Returns the closest pair, without removing it.
+         * @return Pair {inUnconnected, inConnected}, as closestLink() returns.
+         * @throws std::runtime_error If no pair exists (no point left in
+         *   either set).
+         */
+        std::pair<mcpp::Coordinate, mcpp::Coordinate> next();
+
+        /**
+         * @brief Adds a point to the connected set.
+         * @param point New connected point; ties go to older points.
+         */
+        void addConnected(const mcpp::Coordinate& point);
+
+        /**
+         * @brief Removes every unconnected point equal to @p point.
+         * @param point Point to remove.
+         */
+        void removeUnconnected(const mcpp::Coordinate& point);
+
+        /**
+         * @brief Returns the unconnected points not yet removed.
+         * @return Remaining points in their original order.
+         */
+        std::vector<mcpp::Coordinate> remaining() const;
+
+    private:
+        static constexpr int CELL_SHIFT = 4;
+        static constexpr int CELL_SIZE = 1 << CELL_SHIFT;
+
+        /**
+         * @brief Best known link of one unconnected point.
+         */
+        struct Candidate {
+            int dist;
+            int conn;
+            int unconn;
+
+            bool operator<(const Candidate& other) const;
+            bool operator>(const Candidate& other) const;
+        };
+
+        /**
+         * @brief Heap entry ordering unconnected points by their best distance,
+         *   largest first.
+         */
+        struct Farthest {
+            int dist;
+            int unconn;
+
+            bool operator<(const Farthest& other) const;
+            bool operator>(const Farthest& other) const;
+        };
+
+        /**
+         * @brief Point ids bucketed by (x, z) cell.
+         */
+        struct Grid {
+            FlatMap<mcpp::Coordinate2D, int, CoordHash> index;
+            std::vector<Vector<int>> cells;
+            mcpp::Coordinate2D minCell;
+            mcpp::Coordinate2D maxCell;
+        };
+
+        Vector<mcpp::Coordinate> connectedPts;
+        Vector<mcpp::Coordinate> unconnectedPts;
+
+        // per unconnected point: best distance and connected index, -1 if none
+        Vector<int> bestDist;
+        Vector<int> bestConn;
+        Vector<char> isLive;
+        size_t liveCount = 0;
+        size_t unlinkedCount = 0;
+
+        Grid connectedGrid;
+        Grid unconnectedGrid;
+
+        PriorityQueue<Candidate> nearest;
+        PriorityQueue<Farthest> farthest;
+
+        /**
+         * @brief Returns the grid cell of a point.
+         */
+        static mcpp::Coordinate2D cellOf(const mcpp::Coordinate& point);
+
+        /**
+         * @brief Adds point @p id to @p grid.
+         */
+        static void addToGrid(Grid& grid, const mcpp::Coordinate& point, int id);
+
+        /**
+         * @brief Appends the ids in the cells at Chebyshev distance @p ring
+         *   from @p center.
+         * @return False once the ring lies entirely outside the occupied cells.
+         */
+        static bool collectRing(const Grid& grid, const mcpp::Coordinate2D& center,
+                                int ring, Vector<int>& ids);
+
+        /**
+         * @brief 3D Manhattan distance between two points.
+         */
+        static int distance(const mcpp::Coordinate& first,
+                            const mcpp::Coordinate& second);
+
+        /**
+         * @brief Smallest (x, z) Manhattan distance from a point to any cell of
+         *   a ring around the point's own cell.
+         */
+        static int ringDistance(int ring);
+
+        /**
+         * @brief Finds the nearest connected point of unconnected point @p id.
+         */
+        void findNearest(int id);
+
+        /**
+         * @brief Records a new best link of unconnected point @p id.
+         */
+        void setBest(int id, int dist, int conn);
+
+        /**
+         * @brief Largest best distance over the live unconnected points.
+         */
+        int farthestBest();
+};
+
+#endif
@@ -2,105 +2,297 @@
 
 
 
-template<typename K, typename V>
-int Map<K, V>::hash(const K& key) const{
+template<typename K, typename V, typename Alloc>
+int Map<K, V, Alloc>::hash(const K& key) const{
 
     return int(std::hash<K>{}(key) % capacity);
 
 }
 
 
-//will grow when >= 50% full
-template<typename K, typename V>
-void Map<K, V>::maybeResize() {
-    
-    if (count * 2 >= capacity) {
+template<typename K, typename V, typename Alloc>
+int Map<K, V, Alloc>::findSlot(const K& key) const {
+
+    int idx = hash(key);
+
+    bool found = false;
+    while (!found && table[idx].occupied) {
+        if (table[idx].key == key) {
+            found = true;
+        }
+        else {
+            idx = (idx + 1) % capacity;
+        }
+    }
+
+    return idx;
+}
+
 
-        int newCap = capacity * 2;
-        Vector<Entry> newTable(newCap);
+template<typename K, typename V, typename Alloc>
+void Map<K, V, Alloc>::rehash(int newCap) {
 
-        //rehash
-        for (const auto& entry : table) {
-            if (entry.occupied) {
-                int idx = int(std::hash<K>{}(entry.key) % newCap);
+    Vector<Entry, EntryAlloc> newTable(newCap, alloc, AllocStats::MAP);
 
-                while (newTable[idx].occupied) {
-                    idx = (idx + 1) % newCap;
-                }
+    for (const auto& entry : table) {
+        if (entry.occupied) {
+            int idx = int(std::hash<K>{}(entry.key) % newCap);
 
-                newTable[idx] = entry;
-                newTable[idx].occupied = true;
+            while (newTable[idx].occupied) {
+                idx = (idx + 1) % newCap;
             }
+
+            newTable[idx] = entry;
+            newTable[idx].occupied = true;
         }
+    }
+
+    table.swap(newTable);
+    capacity = newCap;
 
-        table = newTable;
-        capacity = newCap;
+    AllocStats::onReallocate(AllocStats::MAP);
+
+    return;
+}
+
+
+//will grow when >= 50% full
+template<typename K, typename V, typename Alloc>
+void Map<K, V, Alloc>::maybeResize() {
+
+    if (count * 2 >= capacity) {
+        rehash(capacity * 2);
     }
 
     return;
 }
 
-template<typename K, typename V>
-Map<K, V>::Map(int cap)
-    : capacity(cap), count(0)
-{
+template<typename K, typename V, typename Alloc>
+Map<K, V, Alloc>::Map(int cap, const Alloc& alloc)
+    : alloc(alloc), table(cap < 2 ? 2 : cap, EntryAlloc(alloc), AllocStats::MAP),
+      capacity(cap < 2 ? 2 : cap), count(0)
+{}
+
 
-    if (capacity < 1) capacity = 1;
-    
-    Vector<Entry> newTable(capacity);
-    table = newTable;
+template<typename K, typename V, typename Alloc>
+bool Map<K, V, Alloc>::contains(const K& key) const {
+
+    return table[findSlot(key)].occupied;
 }
 
 
-template<typename K, typename V>
-bool Map<K, V>::contains(const K& key) const {
+template<typename K, typename V, typename Alloc>
+V* Map<K, V, Alloc>::find(const K& key) {
 
-    int idx = hash(key);
+    Entry& entry = table[findSlot(key)];
 
-    bool found = false;
-    while (!found && table[idx].occupied) {
-        if (table[idx].key == key) {
-            found = true;
-        }
-        else {
-            idx = (idx + 1) % capacity;
+    return entry.occupied ? &entry.value : nullptr;
+}
+
+
+template<typename K, typename V, typename Alloc>
+const V* Map<K, V, Alloc>::find(const K& key) const {
+
+    const Entry& entry = table[findSlot(key)];
+
+    return entry.occupied ? &entry.value : nullptr;
+}
+
+
+template<typename K, typename V, typename Alloc>
+template<typename... Args>
+std::pair<V*, bool> Map<K, V, Alloc>::try_emplace(const K& key, Args&&... args) {
+
+    int idx = findSlot(key);
+    bool inserted = false;
+
+    if (!table[idx].occupied) {
+
+        // the probe only has to be redone if the table actually grew
+        if (count * 2 >= capacity) {
+            maybeResize();
+            idx = findSlot(key);
         }
+
+        table[idx].key = key;
+        table[idx].value = V(std::forward<Args>(args)...);
+        table[idx].occupied = true;
+        ++count;
+
+        inserted = true;
     }
 
-    return found;
+    return {&table[idx].value, inserted};
 }
 
 
-template<typename K, typename V>
-V& Map<K, V>::operator[](const K& key) {
+template<typename K, typename V, typename Alloc>
+std::pair<V*, bool> Map<K, V, Alloc>::insert_or_assign(const K& key, const V& value) {
 
-    int idx = hash(key);
-    
-    bool found = false;
-    while (!found && table[idx].occupied) {
-        if (table[idx].key == key) {
-            found = true;
-        }
-        else {
-            idx = (idx + 1) % capacity;
-        }
+    std::pair<V*, bool> result = try_emplace(key, value);
+
+    if (!result.second) {
+        *result.first = value;
     }
 
-    if (!found) {
-        maybeResize();
+    return result;
+}
+
 
-        idx = hash(key);
+template<typename K, typename V, typename Alloc>
+bool Map<K, V, Alloc>::erase(const K& key) {
 
+    int hole = findSlot(key);
+    bool erased = table[hole].occupied;
+
+    if (erased) {
+        table[hole] = Entry();
+        --count;
+
+        // backward shift: pull later members of the probe chain into the
+        // hole, unless that would move them before their home slot
+        int idx = (hole + 1) % capacity;
         while (table[idx].occupied) {
+            int home = hash(table[idx].key);
+
+            bool homeOutsideGap = (hole <= idx)
+                ? (home <= hole || home > idx)
+                : (home <= hole && home > idx);
+
+            if (homeOutsideGap) {
+                table[hole] = table[idx];
+                table[idx] = Entry();
+                hole = idx;
+            }
+
             idx = (idx + 1) % capacity;
         }
+    }
 
-        table[idx].key = key;
-        table[idx].value = V();
-        table[idx].occupied = true;
-        ++count;
+    return erased;
+}
+
+
+template<typename K, typename V, typename Alloc>
+void Map<K, V, Alloc>::reserve(int n) {
+
+    int newCap = capacity;
+    while (n * 2 >= newCap) {
+        newCap *= 2;
+    }
+
+    if (newCap != capacity) {
+        rehash(newCap);
+    }
+
+    return;
+}
+
+
+template<typename K, typename V, typename Alloc>
+int Map<K, V, Alloc>::getSize() const {
+    return count;
+}
+
+
+template<typename K, typename V, typename Alloc>
+void Map<K, V, Alloc>::clear() {
+
+    for (auto& entry : table) {
+        if (entry.occupied) {
+            entry = Entry();
+        }
+    }
+
+    count = 0;
+
+    return;
+}
+
+
+template<typename K, typename V, typename Alloc>
+V& Map<K, V, Alloc>::operator[](const K& key) {
+
+    return *try_emplace(key).first;
+
+}
+
+
+template<typename K, typename V, typename Alloc>
+typename Map<K, V, Alloc>::iterator Map<K, V, Alloc>::begin() {
+    return iterator(table.begin(), table.end());
+}
+
+template<typename K, typename V, typename Alloc>
+typename Map<K, V, Alloc>::iterator Map<K, V, Alloc>::end() {
+    return iterator(table.end(), table.end());
+}
+
+template<typename K, typename V, typename Alloc>
+typename Map<K, V, Alloc>::const_iterator Map<K, V, Alloc>::begin() const {
+    return const_iterator(table.begin(), table.end());
+}
+
+template<typename K, typename V, typename Alloc>
+typename Map<K, V, Alloc>::const_iterator Map<K, V, Alloc>::end() const {
+    return const_iterator(table.end(), table.end());
+}
+
+
+/* ------------------------------------------
+ * --------------- Iterator -----------------
+ * ------------------------------------------ */
+
+template<typename K, typename V, typename Alloc>
+template<typename E>
+Map<K, V, Alloc>::Iterator<E>::Iterator(E* curr, E* last)
+    : curr(curr), last(last)
+{
+    skipEmpty();
+}
+
+template<typename K, typename V, typename Alloc>
+template<typename E>
+void Map<K, V, Alloc>::Iterator<E>::skipEmpty() {
+
+    while (curr != last && !curr->occupied) {
+        ++curr;
     }
 
-    return table[idx].value;
+    return;
+}
+
+template<typename K, typename V, typename Alloc>
+template<typename E>
+E& Map<K, V, Alloc>::Iterator<E>::operator*() const {
+    return *curr;
+}
+
+template<typename K, typename V, typename Alloc>
+template<typename E>
+E* Map<K, V, Alloc>::Iterator<E>::operator->() const {
+    return curr;
+}
+
+template<typename K, typename V, typename Alloc>
+template<typename E>
+typename Map<K, V, Alloc>::template Iterator<E>&
+Map<K, V, Alloc>::Iterator<E>::operator++() {
+
+    ++curr;
+    skipEmpty();
+
+    return *this;
+}
+
+template<typename K, typename V, typename Alloc>
+template<typename E>
+bool Map<K, V, Alloc>::Iterator<E>::operator==(const Iterator& other) const {
+    return curr == other.curr;
+}
 
-}
\ No newline at end of file
+template<typename K, typename V, typename Alloc>
+template<typename E>
+bool Map<K, V, Alloc>::Iterator<E>::operator!=(const Iterator& other) const {
+    return curr != other.curr;
+}
@@ -2,31 +2,44 @@
 #define MAP_H
 
 
+#include <memory>
+#include <utility>
+
 #include "Vector.h"
 
 
 /**
  * @brief A simple hash map implementation using open addressing.
- * 
+ *
  * Uses linear probing for collision resolution and automatically resizes
- * when the table is more than 50% full.
- * 
+ * when the table is more than 50% full. Erasing uses backward-shift
+ * deletion, so no tombstones are left behind.
+ *
  * @tparam K Type of the key.
  * @tparam V Type of the value.
+ * @tparam Alloc Allocator for the table (rebound to the internal entry type).
  */
-template<typename K, typename V>
+template<typename K, typename V,
+         typename Alloc = std::allocator<std::pair<const K, V>>>
 class Map {
-    private:
+    public:
         /**
-         * @brief Internal structure representing a key-value pair.
+         * @brief A key-value pair stored in the table.
+         *
+         * Exposed through iteration; the key must not be modified.
          */
         struct Entry {
             K key{};
             V value{};
-            bool occupied = false; 
+            bool occupied = false;
         };
 
-        Vector<Entry> table{};
+    private:
+        using EntryAlloc = typename std::allocator_traits<Alloc>::
+            template rebind_alloc<Entry>;
+
+        EntryAlloc alloc;
+        Vector<Entry, EntryAlloc> table;
         int capacity;
         int count;
 
@@ -37,19 +50,69 @@ class Map {
          */
         int hash(const K& key) const;
 
+        /**
+         * @brief Probes for @p key.
+         * @param key The key to search for.
+         * @return Index of the key's slot, or of the empty slot that ended
+         *   the probe if the key is absent.
+         */
+        int findSlot(const K& key) const;
+
         /**
          * @brief Resizes the hash table if it becomes more than 50% full.
-         * 
+         *
          * Rehashes all existing entries into the new table.
          */
         void maybeResize();
 
+        /**
+         * @brief Rehashes every entry into a table of @p newCap slots.
+         * @param newCap The new table capacity.
+         */
+        void rehash(int newCap);
+
     public:
+        using allocator_type = Alloc;
+
+        /**
+         * @brief Forward iterator over the occupied entries.
+         * @tparam E Entry or const Entry.
+         */
+        template<typename E>
+        class Iterator {
+            public:
+                /**
+                 * @brief Creates an iterator at @p curr, skipping empty slots.
+                 * @param curr Current slot.
+                 * @param last One past the final slot.
+                 */
+                Iterator(E* curr, E* last);
+
+                E& operator*() const;
+                E* operator->() const;
+                Iterator& operator++();
+                bool operator==(const Iterator& other) const;
+                bool operator!=(const Iterator& other) const;
+
+            private:
+                /**
+                 * @brief Advances @p curr to the next occupied slot (or @p last).
+                 */
+                void skipEmpty();
+
+                E* curr;
+                E* last;
+        };
+
+        using iterator = Iterator<Entry>;
+        using const_iterator = Iterator<const Entry>;
+
         /**
          * @brief Constructs a map with an initial capacity.
          * @param cap Initial table capacity (defaults to 8).
+         * @param alloc Allocator for the table storage.
          */
-        Map(int cap = 8);
+        Map(int cap = 8, const Alloc& alloc = Alloc());
 
         /**
          * @brief Checks whether the map contains a given key.
@@ -58,15 +121,80 @@ class Map {
          */
         bool contains(const K& key) const;
 
+        /**
+         * @brief Looks up a key without inserting it.
+         * @param key The key to search for.
+         * @return Pointer to the value, or nullptr if the key is absent.
+         *   Valid until the next insertion or erase.
+         */
+        V* find(const K& key);
+
+        /**
+         * @brief Looks up a key without inserting it (const).
+         * @param key The key to search for.
+         * @return Pointer to the value, or nullptr if the key is absent.
+         */
+        const V* find(const K& key) const;
+
+        /**
+         * @brief Inserts @p key with a value built from @p args, if absent.
+         *
+         * Single probe: the existing value is left untouched when the key
+         * is already present.
+         *
+         * @param key The key to look up or insert.
+         * @param args Arguments forwarded to V's constructor on insertion.
+         * @return {pointer to the value, true if it was inserted}.
+         */
+        template<typename... Args>
+        std::pair<V*, bool> try_emplace(const K& key, Args&&... args);
+
+        /**
+         * @brief Inserts @p key or overwrites its value.
+         * @param key The key to insert or update.
+         * @param value The value to store.
+         * @return {pointer to the value, true if it was inserted}.
+         */
+        std::pair<V*, bool> insert_or_assign(const K& key, const V& value);
+
+        /**
+         * @brief Removes a key, shifting its probe chain back into the gap.
+         * @param key The key to remove.
+         * @return True if the key was present.
+         */
+        bool erase(const K& key);
+
+        /**
+         * @brief Grows the table so @p n entries fit without a resize.
+         * @param n Number of entries to make room for.
+         */
+        void reserve(int n);
+
+        /**
+         * @brief Returns the number of entries.
+         * @return The number of keys stored.
+         */
+        int getSize() const;
+
+        /**
+         * @brief Removes all entries. Keeps the table capacity.
+         */
+        void clear();
+
         /**
          * @brief Accesses the value associated with a key.
-         * 
+         *
          * If the key does not exist, it is inserted with a default value.
-         * 
+         *
          * @param key The key to look up or insert.
          * @return Reference to the value associated with the key.
          */
         V& operator[](const K& key);
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
 };
 
 
@@ -74,4 +202,4 @@ class Map {
 #include "Map.cpp"
 
 
-#endif 
\ No newline at end of file
+#endif
\ No newline at end of file
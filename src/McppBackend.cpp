@@ -0,0 +1,37 @@
+#include "McppBackend.h"
+
+
+McppBackend::McppBackend(const std::string& address, int port)
+    : mc(address, port)
+{}
+
+
+mcpp::HeightMap McppBackend::getHeights(const mcpp::Coordinate& loc1,
+                                        const mcpp::Coordinate& loc2) {
+    return mc.getHeights(loc1, loc2);
+}
+
+
+mcpp::Chunk McppBackend::getBlocks(const mcpp::Coordinate& loc1,
+                                   const mcpp::Coordinate& loc2) {
+    return mc.getBlocks(loc1, loc2);
+}
+
+
+void McppBackend::setBlock(const mcpp::Coordinate& loc,
+                           const mcpp::BlockType& blockType) {
+
+    mc.setBlock(loc, blockType);
+
+    return;
+}
+
+
+void McppBackend::setBlocks(const mcpp::Coordinate& loc1,
+                            const mcpp::Coordinate& loc2,
+                            const mcpp::BlockType& blockType) {
+
+    mc.setBlocks(loc1, loc2, blockType);
+
+    return;
+}
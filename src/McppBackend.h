@@ -0,0 +1,41 @@
+#ifndef MCPP_BACKEND_H
+#define MCPP_BACKEND_H
+
+#include <string>
+#include <mcpp/mcpp.h>
+
+#include "WorldBackend.h"
+
+/**
+ * @brief WorldBackend backed by one connection to a live server.
+ *
+ * Like the connection it wraps, it is not thread safe.
+ */
+class McppBackend : public WorldBackend {
+    public:
+        /**
+         * @brief Connects to the server.
+         * @param address Server address.
+         * @param port Server port.
+         */
+        explicit McppBackend(const std::string& address = "localhost",
+                             int port = 4711);
+
+        mcpp::HeightMap getHeights(const mcpp::Coordinate& loc1,
+                                   const mcpp::Coordinate& loc2) override;
+
+        mcpp::Chunk getBlocks(const mcpp::Coordinate& loc1,
+                              const mcpp::Coordinate& loc2) override;
+
+        void setBlock(const mcpp::Coordinate& loc,
+                      const mcpp::BlockType& blockType) override;
+
+        void setBlocks(const mcpp::Coordinate& loc1,
+                       const mcpp::Coordinate& loc2,
+                       const mcpp::BlockType& blockType) override;
+
+    private:
+        mcpp::MinecraftConnection mc;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "OccupancyGrid.h"
+
+
+/* ------------------------------------------
+ * ---------------- Window ------------------
+ * ------------------------------------------ */
+
+OccupancyGrid::Window::Window(mcpp::Coordinate2D origin, int xLen, int zLen)
+    : origin(origin), xLen(xLen < 0 ? 0 : xLen), zLen(zLen < 0 ? 0 : zLen),
+      wordsPerRow((this->zLen + 63) / 64),
+      bits(size_t(this->xLen) * wordsPerRow)
+{}
+
+
+void OccupancyGrid::Window::set(const mcpp::Coordinate2D& c) {
+
+    int x = c.x - origin.x;
+    int z = c.z - origin.z;
+
+    if (x >= 0 && z >= 0 && x < xLen && z < zLen) {
+        bits.begin()[x * wordsPerRow + (z >> 6)] |= uint64_t(1) << (z & 63);
+    }
+
+    return;
+}
+
+
+/* ------------------------------------------
+ * ------------- OccupancyGrid --------------
+ * ------------------------------------------ */
+
+OccupancyGrid::OccupancyGrid() {}
+
+
+const OccupancyGrid::Tile*
+OccupancyGrid::findTile(const mcpp::Coordinate2D& c) const {
+
+    mcpp::Coordinate2D key(c.x >> TILE_SHIFT, c.z >> TILE_SHIFT);
+    const int* idx = tileIndex.find(key);
+
+    return (idx != nullptr) ? &tiles[*idx] : nullptr;
+}
+
+
+OccupancyGrid::Tile& OccupancyGrid::tileFor(const mcpp::Coordinate2D& c) {
+
+    mcpp::Coordinate2D key(c.x >> TILE_SHIFT, c.z >> TILE_SHIFT);
+    std::pair<int*, bool> slot = tileIndex.try_emplace(key, int(tiles.getSize()));
+
+    if (slot.second) {
+        tiles.push_back(Tile());
+    }
+
+    return tiles[*slot.first];
+}
+
+
+void OccupancyGrid::setIn(Tile& tile, const mcpp::Coordinate2D& c) {
+
+    uint64_t& row = tile.rows[c.x & (TILE_SIZE - 1)];
+    uint64_t bit = uint64_t(1) << (c.z & (TILE_SIZE - 1));
+
+    if ((row & bit) == 0) {
+        row |= bit;
+        ++count;
+    }
+
+    return;
+}
+
+
+bool OccupancyGrid::test(const mcpp::Coordinate2D& c) const {
+
+    const Tile* tile = findTile(c);
+
+    bool isSet = false;
+    if (tile != nullptr) {
+        uint64_t row = tile->rows[c.x & (TILE_SIZE - 1)];
+        isSet = ((row >> (c.z & (TILE_SIZE - 1))) & 1u) != 0;
+    }
+
+    return isSet;
+}
+
+
+void OccupancyGrid::set(const mcpp::Coordinate2D& c) {
+
+    setIn(tileFor(c), c);
+
+    return;
+}
+
+
+void OccupancyGrid::setAll(ConstSpan<mcpp::Coordinate2D> coords) {
+
+    Tile* tile = nullptr;
+    mcpp::Coordinate2D tileKey;
+
+    for (const mcpp::Coordinate2D& c : coords) {
+        mcpp::Coordinate2D key(c.x >> TILE_SHIFT, c.z >> TILE_SHIFT);
+
+        // only look the tile up again when the path leaves it; creating a
+        // tile may move the others, but the pointer is replaced right away
+        if (tile == nullptr || key != tileKey) {
+            tile = &tileFor(c);
+            tileKey = key;
+        }
+
+        setIn(*tile, c);
+    }
+
+    return;
+}
+
+
+OccupancyGrid::Window
+OccupancyGrid::extract(const mcpp::Coordinate2D& origin, int xLen, int zLen) const {
+
+    Window window(origin, xLen, zLen);
+
+    for (int x = origin.x; x < origin.x + xLen; ++x) {
+
+        int z = origin.z;
+        while (z < origin.z + zLen) {
+
+            // cells [z, tileEnd) share one tile row
+            int tileStart = z - (z & (TILE_SIZE - 1));
+            int tileEnd = tileStart + TILE_SIZE;
+            int rangeEnd = (tileEnd < origin.z + zLen) ? tileEnd : origin.z + zLen;
+
+            const Tile* tile = findTile(mcpp::Coordinate2D(x, z));
+            if (tile != nullptr) {
+                uint64_t row = tile->rows[x & (TILE_SIZE - 1)];
+
+                while (row != 0) {
+                    int bit = lowestBit(row);
+                    int cellZ = tileStart + bit;
+
+                    if (cellZ >= z && cellZ < rangeEnd) {
+                        window.set(mcpp::Coordinate2D(x, cellZ));
+                    }
+                    row &= row - 1;
+                }
+            }
+
+            z = rangeEnd;
+        }
+    }
+
+    return window;
+}
+
+
+size_t OccupancyGrid::getSize() const {
+    return count;
+}
+
+
+size_t OccupancyGrid::memoryBytes() const {
+
+    // tile payload plus roughly one index slot (key, value, control byte) per tile
+    size_t indexBytes = size_t(tileIndex.getSize()) *
+        (sizeof(mcpp::Coordinate2D) + sizeof(int) + 1);
+
+    return tiles.getSize() * sizeof(Tile) + indexBytes;
+}
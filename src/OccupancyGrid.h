@@ -0,0 +1,158 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mcpp/mcpp.h>
+
+#include "Vector.h"
+#include "FlatMap.h"
+#include "Hash.h"
+#include "Span.h"
+
+/**
+ * @brief Sparse set of occupied (x, z) cells stored as 64x64 bit tiles.
+ *
+ * Tiles are created on first use and looked up through a FlatMap keyed by
+ * tile coordinate; inside a tile each cell is one bit. Compared to a
+ * Map<Coordinate2D, bool>, which stores a full key, a value and a flag per
+ * cell, this needs 512 bytes per touched tile, i.e. one bit per cell once
+ * a tile is populated. The set only grows, matching how connectPoints
+ * registers paths.
+ */
+class OccupancyGrid {
+    public:
+        static constexpr int TILE_SHIFT = 6;
+        static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+
+        /**
+         * @brief A dense bitmask copy of a rectangle of the grid.
+         *
+         * Used by a search to test occupancy without any hashing. Cells
+         * outside the rectangle read as free.
+         */
+        class Window {
+            public:
+                /**
+                 * @brief Creates an empty (all free) window.
+                 * @param origin Minimum (x, z) corner.
+                 * @param xLen Number of cells along x.
+                 * @param zLen Number of cells along z.
+                 */
+                Window(mcpp::Coordinate2D origin = mcpp::Coordinate2D(),
+                       int xLen = 0, int zLen = 0);
+
+                /**
+                 * @brief Checks whether a cell is occupied.
+                 * @param c World coordinate.
+                 * @return True if inside the window and occupied.
+                 */
+                bool test(const mcpp::Coordinate2D& c) const;
+
+                /**
+                 * @brief Marks a cell inside the window as occupied.
+                 * @param c World coordinate (ignored if outside).
+                 */
+                void set(const mcpp::Coordinate2D& c);
+
+            private:
+                mcpp::Coordinate2D origin;
+                int xLen;
+                int zLen;
+                int wordsPerRow;
+                Vector<uint64_t> bits;
+        };
+
+        /**
+         * @brief Creates an empty grid.
+         */
+        OccupancyGrid();
+
+        /**
+         * @brief Checks whether a cell is occupied.
+         * @param c World coordinate.
+         * @return True if the cell was set.
+         */
+        bool test(const mcpp::Coordinate2D& c) const;
+
+        /**
+         * @brief Marks a cell as occupied.
+         * @param c World coordinate.
+         */
+        void set(const mcpp::Coordinate2D& c);
+
+        /**
+         * @brief Marks every cell of @p coords as occupied.
+         *
+         * Consecutive cells of a path usually share a tile, so the tile is
+         * only looked up again when the path crosses into another one.
+         *
+         * @param coords Cells to mark.
+         */
+        void setAll(ConstSpan<mcpp::Coordinate2D> coords);
+
+        /**
+         * @brief Copies a rectangle into a dense bitmask.
+         * @param origin Minimum (x, z) corner of the rectangle.
+         * @param xLen Number of cells along x.
+         * @param zLen Number of cells along z.
+         * @return Window holding the occupancy of the rectangle.
+         */
+        Window extract(const mcpp::Coordinate2D& origin, int xLen, int zLen) const;
+
+        /**
+         * @brief Returns the number of occupied cells.
+         * @return Count of set cells.
+         */
+        size_t getSize() const;
+
+        /**
+         * @brief Returns the bytes used by tile storage.
+         * @return Approximate memory footprint of the grid.
+         */
+        size_t memoryBytes() const;
+
+    private:
+        /**
+         * @brief One 64x64 block of cells; bit z of rows[x] is cell (x, z).
+         */
+        struct Tile {
+            uint64_t rows[TILE_SIZE] = {};
+        };
+
+        /**
+         * @brief Returns the tile holding @p c, or nullptr if none exists.
+         */
+        const Tile* findTile(const mcpp::Coordinate2D& c) const;
+
+        /**
+         * @brief Returns the tile holding @p c, creating it if needed.
+         */
+        Tile& tileFor(const mcpp::Coordinate2D& c);
+
+        /**
+         * @brief Sets the bit of @p c in @p tile, updating the count.
+         */
+        void setIn(Tile& tile, const mcpp::Coordinate2D& c);
+
+        FlatMap<mcpp::Coordinate2D, int, CoordHash> tileIndex{};
+        Vector<Tile> tiles{};
+        size_t count = 0;
+};
+
+
+inline bool OccupancyGrid::Window::test(const mcpp::Coordinate2D& c) const {
+
+    int x = c.x - origin.x;
+    int z = c.z - origin.z;
+
+    bool isSet = false;
+    if (x >= 0 && z >= 0 && x < xLen && z < zLen) {
+        uint64_t word = bits.begin()[x * wordsPerRow + (z >> 6)];
+        isSet = ((word >> (z & 63)) & 1u) != 0;
+    }
+
+    return isSet;
+}
+
+#endif
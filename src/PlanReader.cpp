@@ -0,0 +1,125 @@
+#include "PlanReader.h"
+
+#include <stdexcept>
+
+#include "Cell.h"
+#include "Vector.h"
+
+
+PlanReader::PlanReader(std::istream& in) : in(in) {
+
+    unsigned char header[PlanWriter::HEADER_BYTES] = {};
+    bool isValid = take(header, sizeof(header)) == sizeof(header);
+
+    size_t pos = 0;
+    for (size_t i = 0; isValid && i < sizeof(PlanWriter::MAGIC); ++i) {
+        isValid = getBytes(header, pos, 1) ==
+                  static_cast<unsigned char>(PlanWriter::MAGIC[i]);
+    }
+
+    if (!isValid) {
+        throw std::runtime_error("Not a plan file");
+    }
+    if (getBytes(header, pos, 2) != PlanWriter::VERSION) {
+        throw std::runtime_error("Unsupported plan file version");
+    }
+}
+
+
+bool PlanReader::next(PlanRecord& record) {
+
+    unsigned char fixed[PlanWriter::RECORD_BYTES] = {};
+    size_t got = take(fixed, sizeof(fixed));
+
+    // a clean end of file falls between two records
+    bool hasRecord = got > 0;
+
+    if (hasRecord) {
+        if (got != sizeof(fixed)) {
+            throw std::runtime_error("Truncated plan record");
+        }
+
+        size_t pos = 0;
+        int fields[7] = {};
+        for (int& field : fields) {
+            field = static_cast<int32_t>(getBytes(fixed, pos, 4));
+        }
+
+        record.path.start = mcpp::Coordinate(fields[0], fields[1], fields[2]);
+        record.path.end = mcpp::Coordinate(fields[3], fields[4], fields[5]);
+        record.cost = fields[6];
+        record.fingerprint = getBytes(fixed, pos, 8);
+
+        size_t steps = getBytes(fixed, pos, 4);
+        int x = static_cast<int32_t>(getBytes(fixed, pos, 4));
+        int z = static_cast<int32_t>(getBytes(fixed, pos, 4));
+        mcpp::Coordinate2D coord(x, z);
+
+        Vector<unsigned char> packed((steps + 3) / 4);
+        if (take(packed.begin(), packed.getSize()) != packed.getSize()) {
+            throw std::runtime_error("Truncated plan record");
+        }
+
+        record.plan.clear();
+        record.plan.push_back(coord);
+
+        for (size_t i = 0; i < steps; ++i) {
+            unsigned code = (packed[i / 4] >> (2 * (i % 4))) & 3u;
+
+            switch (Direction(Direction::North + code)) {
+                case Direction::North :
+                    --coord.z;
+                    break;
+                case Direction::South :
+                    ++coord.z;
+                    break;
+                case Direction::West :
+                    --coord.x;
+                    break;
+                default :
+                    ++coord.x;
+                    break;
+            }
+
+            record.plan.push_back(coord);
+        }
+
+        ++count;
+    }
+
+    return hasRecord;
+}
+
+
+size_t PlanReader::getCount() const {
+    return count;
+}
+
+
+size_t PlanReader::bytesRead() const {
+    return bytes;
+}
+
+
+uint64_t PlanReader::getBytes(const unsigned char* buffer, size_t& pos,
+                              size_t size) {
+
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < size; ++i) {
+        value |= uint64_t(buffer[pos]) << (8 * i);
+        ++pos;
+    }
+
+    return value;
+}
+
+
+size_t PlanReader::take(unsigned char* buffer, size_t size) {
+
+    in.read(reinterpret_cast<char*>(buffer), std::streamsize(size));
+    size_t got = size_t(in.gcount());
+    bytes += got;
+
+    return got;
+}
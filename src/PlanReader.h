@@ -0,0 +1,76 @@
+#ifndef PLAN_READER_H
+#define PLAN_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <mcpp/mcpp.h>
+
+#include "SmallVector.h"
+#include "routes.h"
+#include "PlanWriter.h"
+
+#include "../paths.h"
+
+/**
+ * @brief One road read back from a plan file.
+ */
+struct PlanRecord {
+    Path path;
+    int cost = 0;
+    uint64_t fingerprint = 0;
+    SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> plan;
+};
+
+/**
+ * @brief Streams roads out of a file written by PlanWriter, one at a time.
+ */
+class PlanReader {
+    public:
+        /**
+         * @brief Reads and checks the file header.
+         * @param in Stream holding the file; opened in binary mode.
+         * @throws std::runtime_error If the header is missing, is not a plan
+         *   file, or has an unknown version.
+         */
+        explicit PlanReader(std::istream& in);
+
+        /**
+         * @brief Reads the next road.
+         * @param record Receives the road; left unspecified at the end.
+         * @return False once the file has no more records.
+         * @throws std::runtime_error If the file ends inside a record.
+         */
+        bool next(PlanRecord& record);
+
+        /**
+         * @brief Returns the number of records read.
+         * @return Record count.
+         */
+        size_t getCount() const;
+
+        /**
+         * @brief Returns the bytes read, header included.
+         * @return Byte count.
+         */
+        size_t bytesRead() const;
+
+    private:
+        std::istream& in;
+        size_t count = 0;
+        size_t bytes = 0;
+
+        /**
+         * @brief Reads @p size little-endian bytes at @p pos of @p buffer.
+         */
+        static uint64_t getBytes(const unsigned char* buffer, size_t& pos,
+                                 size_t size);
+
+        /**
+         * @brief Reads up to @p size bytes.
+         * @return Number of bytes actually read.
+         */
+        size_t take(unsigned char* buffer, size_t size);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "PlanWriter.h"
+
+#include <stdexcept>
+
+#include "Cell.h"
+#include "Vector.h"
+
+
+PlanWriter::PlanWriter(std::ostream& out) : out(out) {
+
+    unsigned char header[HEADER_BYTES] = {};
+    size_t pos = 0;
+
+    for (char c : MAGIC) {
+        putBytes(header, pos, static_cast<unsigned char>(c), 1);
+    }
+    putBytes(header, pos, VERSION, 2);
+    putBytes(header, pos, 0, 2);
+
+    emit(header, pos);
+}
+
+
+void PlanWriter::write(const Path& path, int cost, uint64_t fingerprint,
+                       ConstSpan<mcpp::Coordinate2D> plan) {
+
+    if (plan.getSize() == 0) {
+        throw std::runtime_error("Empty plan");
+    }
+
+    size_t steps = plan.getSize() - 1;
+    Vector<unsigned char> buffer(RECORD_BYTES + (steps + 3) / 4);
+    size_t pos = 0;
+
+    const int fields[] = {path.start.x, path.start.y, path.start.z,
+                          path.end.x, path.end.y, path.end.z, cost};
+    for (int field : fields) {
+        putBytes(buffer.begin(), pos, static_cast<uint32_t>(field), 4);
+    }
+    putBytes(buffer.begin(), pos, fingerprint, 8);
+    putBytes(buffer.begin(), pos, steps, 4);
+    putBytes(buffer.begin(), pos, static_cast<uint32_t>(plan[0].x), 4);
+    putBytes(buffer.begin(), pos, static_cast<uint32_t>(plan[0].z), 4);
+
+    // the packed bytes start out zeroed, so codes are only or-ed in
+    for (size_t i = 0; i < steps; ++i) {
+        buffer[pos + i / 4] |= stepCode(plan[i], plan[i + 1]) << (2 * (i % 4));
+    }
+
+    emit(buffer.begin(), buffer.getSize());
+    ++count;
+
+    return;
+}
+
+
+size_t PlanWriter::getCount() const {
+    return count;
+}
+
+
+size_t PlanWriter::bytesWritten() const {
+    return bytes;
+}
+
+
+void PlanWriter::putBytes(unsigned char* buffer, size_t& pos,
+                          uint64_t value, size_t size) {
+
+    for (size_t i = 0; i < size; ++i) {
+        buffer[pos] = static_cast<unsigned char>(value >> (8 * i));
+        ++pos;
+    }
+
+    return;
+}
+
+
+unsigned PlanWriter::stepCode(const mcpp::Coordinate2D& from,
+                              const mcpp::Coordinate2D& to) {
+
+    int dx = to.x - from.x;
+    int dz = to.z - from.z;
+
+    Direction direction = Direction::Unknown;
+
+    if (dx == 0 && dz == -1) {
+        direction = Direction::North;
+    }
+    else if (dx == 0 && dz == 1) {
+        direction = Direction::South;
+    }
+    else if (dx == -1 && dz == 0) {
+        direction = Direction::West;
+    }
+    else if (dx == 1 && dz == 0) {
+        direction = Direction::East;
+    }
+    else {
+        throw std::runtime_error("Plan step is not a single move");
+    }
+
+    return unsigned(direction - Direction::North);
+}
+
+
+void PlanWriter::emit(const unsigned char* buffer, size_t size) {
+
+    out.write(reinterpret_cast<const char*>(buffer), std::streamsize(size));
+
+    if (!out) {
+        throw std::runtime_error("Failed to write plan file");
+    }
+
+    bytes += size;
+
+    return;
+}
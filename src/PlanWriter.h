@@ -0,0 +1,91 @@
+#ifndef PLAN_WRITER_H
+#define PLAN_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <mcpp/mcpp.h>
+
+#include "Span.h"
+
+#include "../paths.h"
+
+/**
+ * @brief Streams planned roads to a compact binary plan file.
+ *
+ * The file is a header followed by one record per road, written as soon
+ * as the road is committed, so a plan file never has to be held in memory.
+ * All integers are little-endian.
+ *
+ * Header (8 bytes): the magic "PFPL", then the format version (u16) and
+ * reserved flags (u16, zero).
+ *
+ * Record: start and end (3 x i32 each), cost (i32), terrain fingerprint
+ * (u64), number of steps (u32), the first coordinate of the plan (2 x i32),
+ * then one 2-bit direction per step, four to a byte, lowest bits first.
+ * The directions are the Direction values North, South, West and East
+ * minus North, the only moves findPath makes.
+ */
+class PlanWriter {
+    public:
+        static constexpr char MAGIC[4] = {'P', 'F', 'P', 'L'};
+        static constexpr uint16_t VERSION = 1;
+        static constexpr size_t HEADER_BYTES = 8;
+        static constexpr size_t RECORD_BYTES = 48;
+
+        /**
+         * @brief Writes the file header.
+         * @param out Stream receiving the file; opened in binary mode.
+         * @throws std::runtime_error If the stream fails.
+         */
+        explicit PlanWriter(std::ostream& out);
+
+        /**
+         * @brief Appends one road.
+         * @param path Endpoints of the road.
+         * @param cost Cost of the road as planned.
+         * @param fingerprint Terrain fingerprint (see planFingerprint).
+         * @param plan Route; consecutive coordinates must be one step apart.
+         * @throws std::runtime_error If @p plan is empty or skips a cell, or if
+         *   the stream fails.
+         */
+        void write(const Path& path, int cost, uint64_t fingerprint,
+                   ConstSpan<mcpp::Coordinate2D> plan);
+
+        /**
+         * @brief Returns the number of records written.
+         * @return Record count.
+         */
+        size_t getCount() const;
+
+        /**
+         * @brief Returns the bytes written, header included.
+         * @return Byte count.
+         */
+        size_t bytesWritten() const;
+
+    private:
+        std::ostream& out;
+        size_t count = 0;
+        size_t bytes = 0;
+
+        /**
+         * @brief Appends @p size little-endian bytes of @p value to @p buffer.
+         */
+        static void putBytes(unsigned char* buffer, size_t& pos,
+                             uint64_t value, size_t size);
+
+        /**
+         * @brief Returns the 2-bit code of the step from @p from to @p to.
+         * @throws std::runtime_error If the cells are not neighbors.
+         */
+        static unsigned stepCode(const mcpp::Coordinate2D& from,
+                                 const mcpp::Coordinate2D& to);
+
+        /**
+         * @brief Writes @p size bytes and checks the stream.
+         */
+        void emit(const unsigned char* buffer, size_t size);
+};
+
+#endif
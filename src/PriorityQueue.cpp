@@ -4,33 +4,33 @@
 #include <stdexcept>
 
 
-template<typename T>
-PriorityQueue<T>::PriorityQueue() 
-    : size(0) {
+template<typename T, typename Alloc>
+PriorityQueue<T, Alloc>::PriorityQueue(const Alloc& alloc)
+    : size(0), vec(alloc, AllocStats::PRIORITY_QUEUE) {
         
     // first one needs to be garbage/reserved
     vec.push_back(T());
 }
 
-template<typename T>
-size_t PriorityQueue<T>::parent(size_t i) {
+template<typename T, typename Alloc>
+size_t PriorityQueue<T, Alloc>::parent(size_t i) {
     return i / 2;
 }
 
-template<typename T>
-size_t PriorityQueue<T>::left(size_t i) {
+template<typename T, typename Alloc>
+size_t PriorityQueue<T, Alloc>::left(size_t i) {
     return i * 2;
 }
 
-template<typename T>
-size_t PriorityQueue<T>::right(size_t i) {
+template<typename T, typename Alloc>
+size_t PriorityQueue<T, Alloc>::right(size_t i) {
     return (i * 2) + 1;
 }
 
 
 //recursion
-template<typename T>
-void PriorityQueue<T>::shiftUp(size_t i) {
+template<typename T, typename Alloc>
+void PriorityQueue<T, Alloc>::shiftUp(size_t i) {
 
     if (i == 1) return;
 
@@ -44,8 +44,8 @@ void PriorityQueue<T>::shiftUp(size_t i) {
 }
 
 
-template<typename T>
-void PriorityQueue<T>::shiftDown(size_t i) {
+template<typename T, typename Alloc>
+void PriorityQueue<T, Alloc>::shiftDown(size_t i) {
         
     size_t swapId = i;
 
@@ -66,8 +66,8 @@ void PriorityQueue<T>::shiftDown(size_t i) {
 }
 
 
-template<typename T>
-void PriorityQueue<T>::insert(const T& newVal) {
+template<typename T, typename Alloc>
+void PriorityQueue<T, Alloc>::insert(const T& newVal) {
 
     if (size + 1 >= vec.getSize()) {
         vec.push_back(T()); //placeholder
@@ -81,8 +81,8 @@ void PriorityQueue<T>::insert(const T& newVal) {
 
 
 
-template<typename T>
-T PriorityQueue<T>::pop() {
+template<typename T, typename Alloc>
+T PriorityQueue<T, Alloc>::pop() {
     T maxVal = vec[1];
     
     std::swap(vec[1], vec[size--]);
@@ -92,16 +92,16 @@ T PriorityQueue<T>::pop() {
 }
 
 
-template<typename T>
-const T& PriorityQueue<T>::top() const {
+template<typename T, typename Alloc>
+const T& PriorityQueue<T, Alloc>::top() const {
     return vec[1];
 }
 
 
 
 
-template<typename T>
-bool PriorityQueue<T>::isEmpty() const {
+template<typename T, typename Alloc>
+bool PriorityQueue<T, Alloc>::isEmpty() const {
     return size == 0;
 }
 
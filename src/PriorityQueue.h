@@ -3,6 +3,8 @@
 
 #include <memory>
 
+#include "Vector.h"
+
 /**
  * @brief A generic Min-Heap based priority queue implementation.
  * 
@@ -10,12 +12,13 @@
  * The smallest element (based on operator<) has the highest priority.
  * 
  * @tparam T Type of elements stored in the priority queue.
+ * @tparam Alloc Allocator for the underlying heap storage.
  */
-template<typename T>
+template<typename T, typename Alloc = std::allocator<T>>
 class PriorityQueue {
     private:
         size_t size = 0;
-        Vector<T> vec{};
+        Vector<T, Alloc> vec;
 
         /**
          * @brief Returns the index of the parent node for a given index.
@@ -53,8 +56,9 @@ class PriorityQueue {
     public:
         /**
          * @brief Default constructor. Initializes an empty priority queue.
+         * @param alloc Allocator for the heap storage.
          */
-        PriorityQueue();
+        PriorityQueue(const Alloc& alloc = Alloc());
 
         /**
          * @brief Checks whether the priority queue is empty.
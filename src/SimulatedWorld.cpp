@@ -0,0 +1,295 @@
+#include "SimulatedWorld.h"
+
+#include <algorithm>
+#include <thread>
+
+
+int SimulatedWorld::latticeValue(uint64_t seed, int x, int z, int amplitude) {
+
+    uint64_t packed = (uint64_t(uint32_t(x)) << 32) | uint32_t(z);
+    uint64_t h = mix64(packed ^ mix64(seed));
+
+    return int(h % uint64_t(2 * amplitude + 1)) - amplitude;
+}
+
+
+SimulatedWorld::SimulatedWorld()
+    : options()
+{}
+
+
+SimulatedWorld::SimulatedWorld(const Options& options)
+    : options(options)
+{}
+
+
+void SimulatedWorld::loadHeights(const mcpp::HeightMap& heights) {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    mcpp::Coordinate base = heights.base_pt();
+
+    for (uint32_t x = 0; x < heights.x_len(); ++x) {
+        for (uint32_t z = 0; z < heights.z_len(); ++z) {
+            loadedHeights.insert_or_assign(
+                mcpp::Coordinate2D(base.x + int(x), base.z + int(z)),
+                heights.get(int(x), int(z)));
+        }
+    }
+
+    return;
+}
+
+
+int SimulatedWorld::surfaceAt(int x, int z) const {
+
+    const int* loaded = loadedHeights.find(mcpp::Coordinate2D(x, z));
+
+    int surface = 0;
+    if (loaded != nullptr) {
+        surface = *loaded;
+    }
+    else {
+        // bilinear value noise over a 16-block lattice, in integer math
+        int cellX = x >> NOISE_SHIFT;
+        int cellZ = z >> NOISE_SHIFT;
+        int fx = x & (NOISE_CELL - 1);
+        int fz = z & (NOISE_CELL - 1);
+
+        int amp = options.amplitude;
+        int v00 = latticeValue(options.seed, cellX, cellZ, amp);
+        int v10 = latticeValue(options.seed, cellX + 1, cellZ, amp);
+        int v01 = latticeValue(options.seed, cellX, cellZ + 1, amp);
+        int v11 = latticeValue(options.seed, cellX + 1, cellZ + 1, amp);
+
+        int near = v00 * (NOISE_CELL - fx) + v10 * fx;
+        int far = v01 * (NOISE_CELL - fx) + v11 * fx;
+        int sum = near * (NOISE_CELL - fz) + far * fz;
+
+        surface = options.baseHeight + sum / (NOISE_CELL * NOISE_CELL);
+    }
+
+    return surface;
+}
+
+
+mcpp::BlockType SimulatedWorld::blockAt(int x, int y, int z) const {
+
+    const mcpp::BlockType* overlay = written.find(mcpp::Coordinate(x, y, z));
+
+    mcpp::BlockType block = mcpp::Blocks::AIR;
+    if (overlay != nullptr) {
+        block = *overlay;
+    }
+    else {
+        int surface = surfaceAt(x, z);
+
+        if (y > surface) {
+            block = (y <= options.seaLevel) ? mcpp::Blocks::STILL_WATER
+                                            : mcpp::Blocks::AIR;
+        }
+        else if (y == surface) {
+            block = (surface < options.seaLevel) ? mcpp::Blocks::SAND
+                                                 : mcpp::Blocks::GRASS;
+        }
+        else {
+            block = (y < surface - 3) ? mcpp::Blocks::STONE
+                                      : mcpp::Blocks::DIRT;
+        }
+    }
+
+    return block;
+}
+
+
+int SimulatedWorld::heightAt(int x, int z) const {
+
+    int top = std::max(surfaceAt(x, z), options.seaLevel);
+
+    const int* writtenY = writtenTop.find(mcpp::Coordinate2D(x, z));
+    if (writtenY != nullptr) {
+        top = std::max(top, *writtenY);
+    }
+
+    // writes may have replaced the top with air, so scan down to a block
+    while (top > MIN_Y && blockAt(x, top, z) == mcpp::Blocks::AIR) {
+        --top;
+    }
+
+    return top;
+}
+
+
+void SimulatedWorld::writeAt(const mcpp::Coordinate& loc,
+                             const mcpp::BlockType& blockType) {
+
+    written.insert_or_assign(loc, blockType);
+
+    std::pair<int*, bool> top =
+        writtenTop.try_emplace(mcpp::Coordinate2D(loc.x, loc.z), loc.y);
+    if (!top.second && *top.first < loc.y) {
+        *top.first = loc.y;
+    }
+
+    ++stats.blocksWritten;
+
+    return;
+}
+
+
+void SimulatedWorld::delay(size_t bytes) const {
+
+    std::chrono::microseconds wait = options.latency;
+
+    if (options.bytesPerSecond > 0.0) {
+        wait += std::chrono::microseconds(
+            int64_t(double(bytes) * 1e6 / options.bytesPerSecond));
+    }
+
+    if (wait.count() > 0) {
+        std::this_thread::sleep_for(wait);
+    }
+
+    return;
+}
+
+
+mcpp::HeightMap SimulatedWorld::getHeights(const mcpp::Coordinate& loc1,
+                                           const mcpp::Coordinate& loc2) {
+
+    int minX = std::min(loc1.x, loc2.x);
+    int maxX = std::max(loc1.x, loc2.x);
+    int minZ = std::min(loc1.z, loc2.z);
+    int maxZ = std::max(loc1.z, loc2.z);
+
+    std::vector<int> heights{};
+    heights.reserve(size_t(maxX - minX + 1) * (maxZ - minZ + 1));
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        // same layout as mcpp: index = x * zLen + z
+        for (int x = minX; x <= maxX; ++x) {
+            for (int z = minZ; z <= maxZ; ++z) {
+                heights.push_back(heightAt(x, z));
+            }
+        }
+
+        ++stats.heightCalls;
+        stats.bytesRead += heights.size() * BYTES_PER_HEIGHT;
+    }
+
+    delay(heights.size() * BYTES_PER_HEIGHT);
+
+    return mcpp::HeightMap(loc1, loc2, heights);
+}
+
+
+mcpp::Chunk SimulatedWorld::getBlocks(const mcpp::Coordinate& loc1,
+                                      const mcpp::Coordinate& loc2) {
+
+    mcpp::Coordinate lo(std::min(loc1.x, loc2.x), std::min(loc1.y, loc2.y),
+                        std::min(loc1.z, loc2.z));
+    mcpp::Coordinate hi(std::max(loc1.x, loc2.x), std::max(loc1.y, loc2.y),
+                        std::max(loc1.z, loc2.z));
+
+    std::vector<mcpp::BlockType> blocks{};
+    blocks.reserve(size_t(hi.x - lo.x + 1) * (hi.y - lo.y + 1) * (hi.z - lo.z + 1));
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        // same layout as mcpp: index = y * xLen * zLen + x * zLen + z
+        for (int y = lo.y; y <= hi.y; ++y) {
+            for (int x = lo.x; x <= hi.x; ++x) {
+                for (int z = lo.z; z <= hi.z; ++z) {
+                    blocks.push_back(blockAt(x, y, z));
+                }
+            }
+        }
+
+        ++stats.blockCalls;
+        stats.bytesRead += blocks.size() * BYTES_PER_BLOCK;
+    }
+
+    delay(blocks.size() * BYTES_PER_BLOCK);
+
+    return mcpp::Chunk(loc1, loc2, blocks);
+}
+
+
+void SimulatedWorld::setBlock(const mcpp::Coordinate& loc,
+                              const mcpp::BlockType& blockType) {
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        writeAt(loc, blockType);
+
+        ++stats.writeCalls;
+        stats.bytesWritten += BYTES_PER_WRITE;
+    }
+
+    delay(BYTES_PER_WRITE);
+
+    return;
+}
+
+
+void SimulatedWorld::setBlocks(const mcpp::Coordinate& loc1,
+                               const mcpp::Coordinate& loc2,
+                               const mcpp::BlockType& blockType) {
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (int y = std::min(loc1.y, loc2.y); y <= std::max(loc1.y, loc2.y); ++y) {
+            for (int x = std::min(loc1.x, loc2.x); x <= std::max(loc1.x, loc2.x); ++x) {
+                for (int z = std::min(loc1.z, loc2.z); z <= std::max(loc1.z, loc2.z); ++z) {
+                    writeAt(mcpp::Coordinate(x, y, z), blockType);
+                }
+            }
+        }
+
+        ++stats.writeCalls;
+        stats.bytesWritten += BYTES_PER_WRITE;
+    }
+
+    delay(BYTES_PER_WRITE);
+
+    return;
+}
+
+
+mcpp::BlockType SimulatedWorld::getBlock(const mcpp::Coordinate& loc) const {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    return blockAt(loc.x, loc.y, loc.z);
+}
+
+
+int SimulatedWorld::getHeight(const mcpp::Coordinate2D& loc) const {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    return heightAt(loc.x, loc.z);
+}
+
+
+SimulatedWorld::Stats SimulatedWorld::getStats() const {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    return stats;
+}
+
+
+void SimulatedWorld::resetStats() {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    stats = Stats();
+
+    return;
+}
@@ -0,0 +1,172 @@
+#ifndef SIMULATED_WORLD_H
+#define SIMULATED_WORLD_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <mcpp/mcpp.h>
+
+#include "WorldBackend.h"
+#include "FlatMap.h"
+#include "Hash.h"
+
+/**
+ * @brief In-memory WorldBackend for offline, deterministic runs.
+ *
+ * Terrain is generated from a seed (smooth value noise: stone, dirt and a
+ * grass or sand top, with water up to sea level) or loaded from a
+ * HeightMap. Writes are kept in a sparse overlay and are visible to later
+ * reads, including heights. Each call can be slowed down by a fixed
+ * latency plus its payload size divided by a bandwidth, to model a server
+ * connection.
+ *
+ * Thread safe: the world state is guarded by a mutex, while the injected
+ * delay is spent outside it, so concurrent calls overlap the way calls on
+ * separate connections would.
+ */
+class SimulatedWorld : public WorldBackend {
+    public:
+        static constexpr int MIN_Y = -64;
+        static constexpr int NOISE_SHIFT = 4;
+        static constexpr int NOISE_CELL = 1 << NOISE_SHIFT;
+
+        // approximate wire size of one value in a response or request
+        static constexpr size_t BYTES_PER_HEIGHT = 4;
+        static constexpr size_t BYTES_PER_BLOCK = 6;
+        static constexpr size_t BYTES_PER_WRITE = 32;
+
+        /**
+         * @brief Terrain and connection parameters.
+         */
+        struct Options {
+            uint64_t seed = 1;
+            int baseHeight = 64;
+            int amplitude = 6;
+            int seaLevel = 62;
+
+            // per-call delay; zero disables latency injection
+            std::chrono::microseconds latency{0};
+
+            // payload bytes per second; zero means unlimited
+            double bytesPerSecond = 0.0;
+        };
+
+        /**
+         * @brief Call and traffic counters.
+         */
+        struct Stats {
+            size_t heightCalls = 0;
+            size_t blockCalls = 0;
+            size_t writeCalls = 0;
+            size_t blocksWritten = 0;
+            size_t bytesRead = 0;
+            size_t bytesWritten = 0;
+        };
+
+        /**
+         * @brief Creates a procedurally generated world with default options.
+         */
+        SimulatedWorld();
+
+        /**
+         * @brief Creates a procedurally generated world.
+         * @param options Terrain and latency parameters.
+         */
+        explicit SimulatedWorld(const Options& options);
+
+        SimulatedWorld(const SimulatedWorld&) = delete;
+        SimulatedWorld& operator=(const SimulatedWorld&) = delete;
+
+        /**
+         * @brief Replaces the generated surface with recorded heights.
+         *
+         * Columns covered by @p heights use the given top instead of the
+         * noise; the block layering below and water above stay the same.
+         *
+         * @param heights Height map to load.
+         */
+        void loadHeights(const mcpp::HeightMap& heights);
+
+        mcpp::HeightMap getHeights(const mcpp::Coordinate& loc1,
+                                   const mcpp::Coordinate& loc2) override;
+
+        mcpp::Chunk getBlocks(const mcpp::Coordinate& loc1,
+                              const mcpp::Coordinate& loc2) override;
+
+        void setBlock(const mcpp::Coordinate& loc,
+                      const mcpp::BlockType& blockType) override;
+
+        void setBlocks(const mcpp::Coordinate& loc1,
+                       const mcpp::Coordinate& loc2,
+                       const mcpp::BlockType& blockType) override;
+
+        /**
+         * @brief Reads one block without any injected delay.
+         * @param loc Block position.
+         * @return The current block.
+         */
+        mcpp::BlockType getBlock(const mcpp::Coordinate& loc) const;
+
+        /**
+         * @brief Reads one column height without any injected delay.
+         * @param loc Column position.
+         * @return Highest non-air y of the column.
+         */
+        int getHeight(const mcpp::Coordinate2D& loc) const;
+
+        /**
+         * @brief Returns the counters accumulated so far.
+         * @return Copy of the statistics.
+         */
+        Stats getStats() const;
+
+        /**
+         * @brief Resets all counters to zero. The world is kept.
+         */
+        void resetStats();
+
+    private:
+        /**
+         * @brief Pseudo-random noise lattice value in [-amplitude, amplitude].
+         */
+        static int latticeValue(uint64_t seed, int x, int z, int amplitude);
+
+        /**
+         * @brief Top of the unmodified terrain (loaded or generated).
+         */
+        int surfaceAt(int x, int z) const;
+
+        /**
+         * @brief Current block, including writes. Caller holds the lock.
+         */
+        mcpp::BlockType blockAt(int x, int y, int z) const;
+
+        /**
+         * @brief Current column height, including writes. Caller holds the lock.
+         */
+        int heightAt(int x, int z) const;
+
+        /**
+         * @brief Records one written block. Caller holds the lock.
+         */
+        void writeAt(const mcpp::Coordinate& loc, const mcpp::BlockType& blockType);
+
+        /**
+         * @brief Sleeps for the latency plus the transfer time of @p bytes.
+         */
+        void delay(size_t bytes) const;
+
+        Options options;
+
+        FlatMap<mcpp::Coordinate2D, int, CoordHash> loadedHeights{};
+        FlatMap<mcpp::Coordinate, mcpp::BlockType, BlockCoordHash> written{};
+
+        // highest written y per column, to know where height scans start
+        FlatMap<mcpp::Coordinate2D, int, CoordHash> writtenTop{};
+
+        Stats stats{};
+        mutable std::mutex lock;
+};
+
+#endif
@@ -0,0 +1,264 @@
+#include "SmallVector.h"
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+template<typename T, size_t N>
+bool SmallVector<T, N>::isInline() const {
+    return data == inlineData();
+}
+
+template<typename T, size_t N>
+T* SmallVector<T, N>::inlineData() {
+    return reinterpret_cast<T*>(inlineStorage);
+}
+
+template<typename T, size_t N>
+const T* SmallVector<T, N>::inlineData() const {
+    return reinterpret_cast<const T*>(inlineStorage);
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::reAlloc(size_t newCapacity) {
+
+    while (size > newCapacity) {
+        pop_back();
+    }
+
+    T* newBlock = (newCapacity <= N) ? inlineData()
+        : static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+
+    if (newBlock != data) {
+        for (size_t i = 0; i < size; ++i) {
+            new (newBlock + i) T(std::move(data[i]));
+            data[i].~T();
+        }
+
+        if (!isInline()) {
+            ::operator delete(data);
+        }
+    }
+
+    data = newBlock;
+    capacity = (newCapacity <= N) ? N : newCapacity;
+
+    return;
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::release() {
+
+    clear();
+
+    if (!isInline()) {
+        ::operator delete(data);
+        data = inlineData();
+        capacity = N;
+    }
+
+    return;
+}
+
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector()
+    : data(inlineData()), capacity(N), size(0)
+{}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(size_t size)
+    : data(inlineData()), capacity(N), size(0)
+{
+    if (size > N) {
+        reAlloc(size);
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        new (data + i) T();
+    }
+    this->size = size;
+}
+
+
+template<typename T, size_t N>
+SmallVector<T, N>::~SmallVector() {
+    release();
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(const SmallVector& other)
+    : data(inlineData()), capacity(N), size(0)
+{
+    *this = other;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(SmallVector&& other)
+    : data(inlineData()), capacity(N), size(0)
+{
+    *this = std::move(other);
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(const std::vector<T>& v)
+    : data(inlineData()), capacity(N), size(0)
+{
+    *this = v;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& other) {
+
+    if (this != &other) {
+        clear();
+        if (other.size > capacity) {
+            reAlloc(other.size);
+        }
+
+        for (size_t i = 0; i < other.size; ++i) {
+            new (data + i) T(other.data[i]);
+        }
+        size = other.size;
+    }
+
+    return *this;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& other) {
+
+    if (this != &other) {
+
+        release();
+
+        // a spilled vector hands over its heap block, an inline one is moved
+        // element by element
+        if (!other.isInline()) {
+            data = other.data;
+            capacity = other.capacity;
+            size = other.size;
+
+            other.data = other.inlineData();
+            other.capacity = N;
+            other.size = 0;
+        }
+        else {
+            for (size_t i = 0; i < other.size; ++i) {
+                new (data + i) T(std::move(other.data[i]));
+            }
+            size = other.size;
+            other.clear();
+        }
+    }
+
+    return *this;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(const std::vector<T>& v) {
+
+    clear();
+    if (v.size() > capacity) {
+        reAlloc(v.size());
+    }
+
+    std::uninitialized_copy(v.begin(), v.end(), data);
+    size = v.size();
+
+    return *this;
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::push_back(const T& value) {
+
+    if (size >= capacity) {
+        reAlloc(capacity * GROW_FACTOR);
+    }
+
+    new (data + size) T(value);
+    ++size;
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::push_back(T&& value) {
+
+    if (size >= capacity) {
+        reAlloc(capacity * GROW_FACTOR);
+    }
+
+    new (data + size) T(std::move(value));
+    ++size;
+}
+
+
+template<typename T, size_t N>
+void SmallVector<T, N>::pop_back() {
+
+    if (size > 0) {
+        --size;
+        data[size].~T();
+    }
+
+    return;
+}
+
+
+template<typename T, size_t N>
+void SmallVector<T, N>::clear() {
+
+    while (size > 0) {
+        pop_back();
+    }
+
+    return;
+}
+
+template<typename T, size_t N>
+size_t SmallVector<T, N>::getSize() const {
+    return size;
+}
+
+
+template<typename T, size_t N>
+const T& SmallVector<T, N>::operator[](size_t index) const {
+
+    if (index >= size) {
+        throw std::runtime_error("Out of bounds access");
+    }
+
+    return data[index];
+}
+
+
+template<typename T, size_t N>
+T& SmallVector<T, N>::operator[](size_t index) {
+
+    if (index >= size) {
+        throw std::runtime_error("Out of bounds access");
+    }
+
+    return data[index];
+}
+
+
+template<typename T, size_t N>
+T* SmallVector<T, N>::begin() {
+    return data;
+}
+
+template<typename T, size_t N>
+T* SmallVector<T, N>::end() {
+    return data + size;
+}
+
+template<typename T, size_t N>
+const T* SmallVector<T, N>::begin() const {
+    return data;
+}
+
+template<typename T, size_t N>
+const T* SmallVector<T, N>::end() const {
+    return data + size;
+}
@@ -0,0 +1,203 @@
+#ifndef SMALL_VECT_H
+#define SMALL_VECT_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+
+/**
+ * @brief A dynamic array that keeps its first N elements inline.
+ *
+ * Behaves like Vector, but storage for up to @p N elements lives inside
+ * the object itself. The heap is only touched once the size grows past
+ * @p N, so short-lived small lists (neighbors, short routes) never call
+ * the allocator. The inline slots are raw storage: only the first
+ * getSize() of them hold constructed elements, so an empty vector
+ * constructs nothing and T need not be default-constructible.
+ *
+ * @tparam T Type of elements stored in the vector.
+ * @tparam N Number of elements stored inline before spilling to the heap.
+ */
+template<typename T, size_t N>
+class SmallVector {
+    private:
+
+        static_assert(N > 0, "SmallVector needs at least one inline slot");
+
+        static constexpr int GROW_FACTOR = 2;
+
+        alignas(T) unsigned char inlineStorage[N * sizeof(T)];
+        T* data = inlineData();
+        size_t capacity = N;
+        size_t size = 0;
+
+
+    private:
+    /**
+     * @brief Moves the elements into a heap block of a new capacity.
+     *
+     * Never shrinks below the inline capacity; when @p newCapacity fits
+     * inline the elements are moved back into the inline storage.
+     *
+     * @param newCapacity The new capacity to allocate.
+     */
+    void reAlloc(size_t newCapacity);
+
+    /**
+     * @brief Checks whether the elements currently live in inline storage.
+     * @return True if no heap block is held.
+     */
+    bool isInline() const;
+
+    /**
+     * @brief Returns the inline slots viewed as elements.
+     * @return Pointer to the first inline slot.
+     */
+    T* inlineData();
+
+    /**
+     * @brief Returns the inline slots viewed as elements (const).
+     * @return Const pointer to the first inline slot.
+     */
+    const T* inlineData() const;
+
+    /**
+     * @brief Destroys the elements and frees the heap block, if any.
+     *
+     * Leaves the vector empty and back on its inline storage.
+     */
+    void release();
+
+    public:
+        /**
+         * @brief Default constructor. Creates an empty vector using inline storage.
+         */
+        SmallVector();
+
+        /**
+         * @brief Constructs a vector with a given initial size.
+         * @param size Number of value-initialized elements.
+         */
+        SmallVector(size_t size);
+
+        /**
+         * @brief Copy constructor.
+         * @param other The vector to copy from.
+         */
+        SmallVector(const SmallVector& other);
+
+        /**
+         * @brief Move constructor. Steals the heap block if @p other spilled.
+         * @param other The vector to move from (left empty).
+         */
+        SmallVector(SmallVector&& other);
+
+        /**
+         * @brief Constructs from an std::vector.
+         * @param v The std::vector to copy data from.
+         */
+        SmallVector(const std::vector<T>& v);
+
+        /**
+         * @brief Destructor. Frees the heap block, if any.
+         */
+        ~SmallVector();
+
+        /**
+         * @brief Copy assignment operator.
+         * @param other The vector to assign from.
+         * @return Reference to this vector.
+         */
+        SmallVector& operator=(const SmallVector& other);
+
+        /**
+         * @brief Move assignment operator.
+         * @param other The vector to move from (left empty).
+         * @return Reference to this vector.
+         */
+        SmallVector& operator=(SmallVector&& other);
+
+        /**
+         * @brief Assigns from an std::vector.
+         * @param v The std::vector to copy data from.
+         * @return Reference to this vector.
+         */
+        SmallVector& operator=(const std::vector<T>& v);
+
+        /**
+         * @brief Adds a new element to the end of the vector (copy version).
+         * @param value The value to add.
+         */
+        void push_back(const T& value);
+
+        /**
+         * @brief Adds a new element to the end of the vector (move version).
+         * @param value The value to move into the vector.
+         */
+        void push_back(T&& value);
+
+        /**
+         * @brief Removes the last element of the vector.
+         */
+        void pop_back();
+
+        /**
+         * @brief Clears all elements from the vector. Keeps the capacity.
+         */
+        void clear();
+
+        /**
+         * @brief Returns the number of elements currently stored.
+         * @return The number of elements in the vector.
+         */
+        size_t getSize() const;
+
+        /**
+         * @brief Access element at given index (const).
+         * @param index Position of the element.
+         * @return Const reference to the element.
+         * @throws std::runtime_error if index is out of bounds.
+         */
+        const T& operator[](size_t index) const;
+
+        /**
+         * @brief Access element at given index (non-const).
+         * @param index Position of the element.
+         * @return Reference to the element.
+         * @throws std::runtime_error if index is out of bounds.
+         */
+        T& operator[](size_t index);
+
+        /**
+         * @brief Returns pointer to the beginning of the data.
+         * @return Pointer to the first element.
+         */
+        T* begin();
+
+        /**
+         * @brief Returns pointer past the last element.
+         * @return Pointer to one-past-the-end element.
+         */
+        T* end();
+
+        /**
+         * @brief Returns const pointer to the beginning of the data.
+         * @return Const pointer to the first element.
+         */
+        const T* begin() const;
+
+        /**
+         * @brief Returns const pointer past the last element.
+         * @return Const pointer to one-past-the-end element.
+         */
+        const T* end() const;
+
+};
+
+
+#include "SmallVector.cpp"
+
+
+#endif
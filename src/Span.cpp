@@ -0,0 +1,90 @@
+#include "Span.h"
+
+#include <stdexcept>
+
+
+template<typename T>
+Span<T>::Span()
+    : data(nullptr), size(0)
+{}
+
+template<typename T>
+Span<T>::Span(T* data, size_t size)
+    : data(data), size(size)
+{}
+
+template<typename T>
+template<typename Alloc>
+Span<T>::Span(Vector<Elem, Alloc>& v)
+    : data(v.begin()), size(v.getSize())
+{}
+
+template<typename T>
+template<typename Alloc>
+Span<T>::Span(const Vector<Elem, Alloc>& v)
+    : data(v.begin()), size(v.getSize())
+{}
+
+template<typename T>
+template<size_t N>
+Span<T>::Span(SmallVector<Elem, N>& v)
+    : data(v.begin()), size(v.getSize())
+{}
+
+template<typename T>
+template<size_t N>
+Span<T>::Span(const SmallVector<Elem, N>& v)
+    : data(v.begin()), size(v.getSize())
+{}
+
+template<typename T>
+template<typename Alloc>
+Span<T>::Span(std::vector<Elem, Alloc>& v)
+    : data(v.data()), size(v.size())
+{}
+
+template<typename T>
+template<typename Alloc>
+Span<T>::Span(const std::vector<Elem, Alloc>& v)
+    : data(v.data()), size(v.size())
+{}
+
+template<typename T>
+template<typename U, typename>
+Span<T>::Span(const Span<U>& other)
+    : data(other.begin()), size(other.getSize())
+{}
+
+
+template<typename T>
+size_t Span<T>::getSize() const {
+    return size;
+}
+
+
+template<typename T>
+T& Span<T>::operator[](size_t index) const {
+
+    if (index >= size) {
+        throw std::runtime_error("Out of bounds access");
+    }
+
+    return data[index];
+}
+
+
+template<typename T>
+T* Span<T>::begin() const {
+    return data;
+}
+
+template<typename T>
+T* Span<T>::end() const {
+    return data + size;
+}
+
+
+template<typename T>
+std::vector<typename Span<T>::Elem> Span<T>::toStdVector() const {
+    return std::vector<Elem>(data, data + size);
+}
@@ -0,0 +1,135 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "Vector.h"
+#include "SmallVector.h"
+
+
+/**
+ * @brief A non-owning view over a contiguous run of elements.
+ *
+ * Converts implicitly (and without copying) from Vector, SmallVector and
+ * std::vector, so read-only parameters can accept any of them. The viewed
+ * container must outlive the span and must not grow while it is in use.
+ *
+ * @tparam T Element type; use a const type (see ConstSpan) for read-only views.
+ */
+template<typename T>
+class Span {
+    private:
+        using Elem = typename std::remove_const<T>::type;
+
+        T* data = nullptr;
+        size_t size = 0;
+
+    public:
+        /**
+         * @brief Creates an empty view.
+         */
+        Span();
+
+        /**
+         * @brief Views @p size elements starting at @p data.
+         * @param data Pointer to the first element.
+         * @param size Number of elements.
+         */
+        Span(T* data, size_t size);
+
+        /**
+         * @brief Views the elements of a Vector.
+         * @param v The vector to view.
+         */
+        template<typename Alloc>
+        Span(Vector<Elem, Alloc>& v);
+
+        /**
+         * @brief Views the elements of a const Vector (const spans only).
+         * @param v The vector to view.
+         */
+        template<typename Alloc>
+        Span(const Vector<Elem, Alloc>& v);
+
+        /**
+         * @brief Views the elements of a SmallVector.
+         * @param v The vector to view.
+         */
+        template<size_t N>
+        Span(SmallVector<Elem, N>& v);
+
+        /**
+         * @brief Views the elements of a const SmallVector (const spans only).
+         * @param v The vector to view.
+         */
+        template<size_t N>
+        Span(const SmallVector<Elem, N>& v);
+
+        /**
+         * @brief Views the elements of an std::vector.
+         * @param v The std::vector to view.
+         */
+        template<typename Alloc>
+        Span(std::vector<Elem, Alloc>& v);
+
+        /**
+         * @brief Views the elements of a const std::vector (const spans only).
+         * @param v The std::vector to view.
+         */
+        template<typename Alloc>
+        Span(const std::vector<Elem, Alloc>& v);
+
+        /**
+         * @brief Converts a mutable view into a read-only one.
+         * @param other The view to convert.
+         */
+        template<typename U, typename = typename std::enable_if<
+            std::is_same<const U, T>::value>::type>
+        Span(const Span<U>& other);
+
+        /**
+         * @brief Returns the number of elements viewed.
+         * @return The number of elements.
+         */
+        size_t getSize() const;
+
+        /**
+         * @brief Access element at given index.
+         * @param index Position of the element.
+         * @return Reference to the element.
+         * @throws std::runtime_error if index is out of bounds.
+         */
+        T& operator[](size_t index) const;
+
+        /**
+         * @brief Returns pointer to the first element.
+         * @return Pointer to the first element.
+         */
+        T* begin() const;
+
+        /**
+         * @brief Returns pointer past the last element.
+         * @return Pointer to one-past-the-end element.
+         */
+        T* end() const;
+
+        /**
+         * @brief Copies the viewed elements into a new std::vector.
+         * @return Owning copy of the elements.
+         */
+        std::vector<Elem> toStdVector() const;
+};
+
+/**
+ * @brief A read-only view; what read-only parameters should take.
+ */
+template<typename T>
+using ConstSpan = Span<const T>;
+
+
+#include "Span.cpp"
+
+
+#endif
@@ -0,0 +1,144 @@
+#include "SurfaceSlab.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+SurfaceSlab::SurfaceSlab(const mcpp::HeightMap& heights, int below, int above)
+    : base(heights.base_pt()),
+      xLen(int(heights.x_len())),
+      zLen(int(heights.z_len())),
+      depth(below + above + 1),
+      firstY(size_t(xLen) * zLen),
+      bottoms(size_t(xLen) * zLen),
+      tops(size_t(xLen) * zLen),
+      blocks(size_t(xLen) * zLen * depth) {
+
+    for (int x = 0; x < xLen; ++x) {
+        for (int z = 0; z < zLen; ++z) {
+            int column = x * zLen + z;
+            int height = heights.get(x, z);
+
+            firstY[column] = height - below;
+            bottoms[column] = height - below;
+            tops[column] = height + above;
+        }
+    }
+}
+
+
+SurfaceSlab SurfaceSlab::fromChunk(const mcpp::Chunk& chunk,
+                                   const mcpp::HeightMap& heights,
+                                   int below, int above) {
+
+    SurfaceSlab slab(heights, below, above);
+
+    mcpp::Coordinate chunkBase = chunk.base_pt();
+    int chunkTop = chunkBase.y + int(chunk.y_len()) - 1;
+
+    for (int x = 0; x < slab.xLen; ++x) {
+        for (int z = 0; z < slab.zLen; ++z) {
+            int column = x * slab.zLen + z;
+            int worldX = slab.base.x + x;
+            int worldZ = slab.base.z + z;
+
+            bool isInChunk = worldX >= chunkBase.x && worldZ >= chunkBase.z &&
+                worldX < chunkBase.x + int(chunk.x_len()) &&
+                worldZ < chunkBase.z + int(chunk.z_len());
+
+            int bottom = std::max(slab.bottoms[column], chunkBase.y);
+            int top = std::min(slab.tops[column], chunkTop);
+
+            // an empty range (bottom > top) makes every query throw
+            if (!isInChunk) {
+                top = bottom - 1;
+            }
+
+            for (int y = bottom; y <= top; ++y) {
+                slab.blocks[size_t(column) * slab.depth + (y - slab.firstY[column])] =
+                    chunk.get(worldX - chunkBase.x, y - chunkBase.y, worldZ - chunkBase.z);
+            }
+
+            slab.bottoms[column] = bottom;
+            slab.tops[column] = top;
+        }
+    }
+
+    return slab;
+}
+
+
+int SurfaceSlab::columnOf(int x, int z) const {
+
+    int localX = x - base.x;
+    int localZ = z - base.z;
+
+    bool isInside = localX >= 0 && localZ >= 0 && localX < xLen && localZ < zLen;
+
+    return isInside ? localX * zLen + localZ : -1;
+}
+
+
+bool SurfaceSlab::contains(const mcpp::Coordinate& pos) const {
+
+    int column = columnOf(pos.x, pos.z);
+
+    return column != -1 && pos.y >= bottoms.begin()[column] &&
+           pos.y <= tops.begin()[column];
+}
+
+
+mcpp::BlockType SurfaceSlab::get_worldspace(const mcpp::Coordinate& pos) const {
+
+    if (!contains(pos)) {
+        throw std::out_of_range("Out of bounds access");
+    }
+
+    int column = columnOf(pos.x, pos.z);
+
+    return blocks.begin()[size_t(column) * depth + (pos.y - firstY.begin()[column])];
+}
+
+
+void SurfaceSlab::set(const mcpp::Coordinate& pos, const mcpp::BlockType& block) {
+
+    if (!contains(pos)) {
+        throw std::out_of_range("Out of bounds access");
+    }
+
+    int column = columnOf(pos.x, pos.z);
+    blocks[size_t(column) * depth + (pos.y - firstY[column])] = block;
+
+    return;
+}
+
+
+int SurfaceSlab::bottomAt(const mcpp::Coordinate2D& column) const {
+    return bottoms[columnOf(column.x, column.z)];
+}
+
+
+int SurfaceSlab::topAt(const mcpp::Coordinate2D& column) const {
+    return tops[columnOf(column.x, column.z)];
+}
+
+
+mcpp::Coordinate2D SurfaceSlab::base_pt() const {
+    return base;
+}
+
+
+int SurfaceSlab::x_len() const {
+    return xLen;
+}
+
+
+int SurfaceSlab::z_len() const {
+    return zLen;
+}
+
+
+size_t SurfaceSlab::memoryBytes() const {
+    return blocks.getSize() * sizeof(mcpp::BlockType) +
+           3 * firstY.getSize() * sizeof(int);
+}
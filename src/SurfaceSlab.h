@@ -0,0 +1,115 @@
+#ifndef SURFACE_SLAB_H
+#define SURFACE_SLAB_H
+
+#include <cstddef>
+#include <mcpp/mcpp.h>
+
+#include "Vector.h"
+
+/**
+ * @brief The blocks around the surface of every column of a region.
+ *
+ * Path finding and building only look at blocks at, just below, or just
+ * above the terrain surface. Instead of a full cuboid, this keeps for each
+ * (x, z) column the blocks in [height - below, height + above], stored
+ * column-major so one column is contiguous.
+ *
+ * get_worldspace() follows the contract of mcpp::Chunk::get_worldspace:
+ * it returns the block or throws std::out_of_range when the position is
+ * not held (outside the region or outside the column's slab).
+ */
+class SurfaceSlab {
+    public:
+        static constexpr int DEFAULT_BELOW = 4;
+        static constexpr int DEFAULT_ABOVE = 4;
+
+        /**
+         * @brief Creates a slab shaped by @p heights, filled with air.
+         * @param heights Surface height of every column of the region.
+         * @param below Blocks kept below the surface.
+         * @param above Blocks kept above the surface.
+         */
+        explicit SurfaceSlab(const mcpp::HeightMap& heights,
+                             int below = DEFAULT_BELOW,
+                             int above = DEFAULT_ABOVE);
+
+        /**
+         * @brief Copies the surface blocks out of a full cuboid.
+         *
+         * Parts of a slab outside @p chunk's y range are left out, so they
+         * throw just like the chunk would.
+         *
+         * @param chunk Blocks of the region.
+         * @param heights Surface height of every column of the region.
+         * @param below Blocks kept below the surface.
+         * @param above Blocks kept above the surface.
+         * @return Slab holding the chunk's blocks around the surface.
+         */
+        static SurfaceSlab fromChunk(const mcpp::Chunk& chunk,
+                                     const mcpp::HeightMap& heights,
+                                     int below = DEFAULT_BELOW,
+                                     int above = DEFAULT_ABOVE);
+
+        /**
+         * @brief Returns the block at a world position.
+         * @param pos World coordinate.
+         * @return The stored block.
+         * @throws std::out_of_range If @p pos is not held by the slab.
+         */
+        mcpp::BlockType get_worldspace(const mcpp::Coordinate& pos) const;
+
+        /**
+         * @brief Checks whether a world position is held by the slab.
+         * @param pos World coordinate.
+         * @return True if get_worldspace(@p pos) would not throw.
+         */
+        bool contains(const mcpp::Coordinate& pos) const;
+
+        /**
+         * @brief Stores a block at a world position.
+         * @param pos World coordinate; must be held by the slab.
+         * @param block Block to store.
+         */
+        void set(const mcpp::Coordinate& pos, const mcpp::BlockType& block);
+
+        /**
+         * @brief Lowest y held in a column, for a column inside the region.
+         */
+        int bottomAt(const mcpp::Coordinate2D& column) const;
+
+        /**
+         * @brief Highest y held in a column, for a column inside the region.
+         */
+        int topAt(const mcpp::Coordinate2D& column) const;
+
+        mcpp::Coordinate2D base_pt() const;
+        int x_len() const;
+        int z_len() const;
+
+        /**
+         * @brief Returns the bytes used by the stored blocks and bounds.
+         * @return Approximate memory footprint.
+         */
+        size_t memoryBytes() const;
+
+    private:
+        /**
+         * @brief Column index of @p pos, or -1 if outside the region.
+         */
+        int columnOf(int x, int z) const;
+
+        mcpp::Coordinate2D base;
+        int xLen;
+        int zLen;
+        int depth;
+
+        // per column: y of the first stored block, and the y range held
+        // (narrower than the slab when built from a clipped chunk)
+        Vector<int> firstY;
+        Vector<int> bottoms;
+        Vector<int> tops;
+
+        Vector<mcpp::BlockType> blocks;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstdio>
+
+
+std::atomic<bool> Trace::enabled{false};
+const std::chrono::steady_clock::time_point Trace::origin = std::chrono::steady_clock::now();
+
+std::mutex Trace::registryLock;
+std::vector<std::unique_ptr<Trace::Ring>> Trace::rings{};
+std::vector<Trace::Ring*> Trace::freeRings{};
+std::vector<std::string> Trace::rowNames{};
+uint32_t Trace::nextTid = 1;
+
+thread_local Trace::Lane Trace::current{};
+
+
+Trace::Lane::~Lane() {
+
+    if (ring != nullptr) {
+        std::lock_guard<std::mutex> guard(registryLock);
+        freeRings.push_back(ring);
+    }
+}
+
+
+Trace::Lane& Trace::lane() {
+
+    Lane& self = current;
+
+    if (self.ring == nullptr || self.tid == 0) {
+        std::lock_guard<std::mutex> guard(registryLock);
+
+        if (self.tid == 0) {
+            self.tid = nextTid++;
+            rowNames.push_back("thread " + std::to_string(self.tid));
+        }
+
+        if (self.ring == nullptr && !freeRings.empty()) {
+            self.ring = freeRings.back();
+            freeRings.pop_back();
+        }
+        else if (self.ring == nullptr) {
+            rings.push_back(std::unique_ptr<Ring>(new Ring()));
+            self.ring = rings.back().get();
+            self.ring->events.resize(RING_CAPACITY);
+        }
+    }
+
+    return self;
+}
+
+
+void Trace::setEnabled(bool isOn) {
+
+    enabled.store(isOn, std::memory_order_relaxed);
+
+    return;
+}
+
+
+bool Trace::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+}
+
+
+void Trace::record(const char* name, int64_t start, int64_t duration, int64_t arg) {
+
+    Lane& self = lane();
+    Ring& ring = *self.ring;
+
+    ring.events[ring.written % RING_CAPACITY] = Event{name, start, duration, arg, self.tid};
+    ++ring.written;
+
+    return;
+}
+
+
+void Trace::nameThread(const char* name, int index) {
+
+    std::string row = index < 0 ? std::string(name) : name + (" " + std::to_string(index));
+
+    std::lock_guard<std::mutex> guard(registryLock);
+
+    uint32_t tid = 0;
+    for (size_t i = 0; tid == 0 && i < rowNames.size(); ++i) {
+        if (rowNames[i] == row) {
+            tid = uint32_t(i + 1);
+        }
+    }
+
+    if (tid == 0) {
+        tid = nextTid++;
+        rowNames.push_back(row);
+    }
+
+    current.tid = tid;
+
+    return;
+}
+
+
+size_t Trace::writeJson(std::ostream& out) {
+
+    std::lock_guard<std::mutex> guard(registryLock);
+
+    size_t count = 0;
+    char line[256];
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    for (size_t i = 0; i < rowNames.size(); ++i) {
+        out << (i == 0 ? "" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (i + 1)
+            << ",\"args\":{\"name\":\"" << rowNames[i] << "\"}}";
+    }
+
+    for (const std::unique_ptr<Ring>& ring : rings) {
+        // the oldest span left is the next one to be overwritten
+        size_t first = ring->written > RING_CAPACITY ? ring->written - RING_CAPACITY : 0;
+
+        for (size_t n = first; n < ring->written; ++n) {
+            const Event& event = ring->events[n % RING_CAPACITY];
+
+            // timestamps are in microseconds
+            int length = std::snprintf(line, sizeof(line),
+                "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                event.name, unsigned(event.tid), double(event.start) / 1e3,
+                double(event.duration) / 1e3);
+
+            out << (rowNames.empty() && count == 0 ? "" : ",\n");
+            out.write(line, std::min<std::streamsize>(length, sizeof(line) - 1));
+
+            if (event.arg != NO_ARG) {
+                out << ",\"args\":{\"n\":" << event.arg << "}";
+            }
+            out << "}";
+
+            ++count;
+        }
+    }
+
+    out << "\n]}\n";
+
+    return count;
+}
+
+
+size_t Trace::getDropped() {
+
+    std::lock_guard<std::mutex> guard(registryLock);
+
+    size_t dropped = 0;
+    for (const std::unique_ptr<Ring>& ring : rings) {
+        dropped += ring->written > RING_CAPACITY ? ring->written - RING_CAPACITY : 0;
+    }
+
+    return dropped;
+}
+
+
+void Trace::clear() {
+
+    std::lock_guard<std::mutex> guard(registryLock);
+
+    for (const std::unique_ptr<Ring>& ring : rings) {
+        ring->written = 0;
+    }
+
+    return;
+}
+
+
+TraceScope::TraceScope(const char* name, int64_t arg)
+    : name(name), arg(arg), isActive(Trace::isEnabled()) {
+
+    if (isActive) {
+        start = Trace::now();
+    }
+}
+
+
+TraceScope::~TraceScope() {
+
+    if (isActive) {
+        Trace::record(name, start, Trace::now() - start, arg);
+    }
+}
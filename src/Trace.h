@@ -0,0 +1,178 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Scoped timeline spans, exported as Chrome trace / Perfetto JSON.
+ *
+ * Spans are only compiled in with PATHFIND_TRACE defined (e.g.
+ * -DPATHFIND_TRACE); without it TRACE_SCOPE and TRACE_THREAD expand to
+ * nothing. When compiled in, spans are recorded only while setEnabled(true)
+ * is in effect, so a disabled span costs one relaxed atomic load.
+ *
+ * Each thread appends to a ring of its own, without locking; a full ring
+ * overwrites its oldest spans. Rings of finished threads are handed to the
+ * next new thread, so short-lived fetch workers do not pile up rings.
+ * Export and clear must not run while traced threads are still recording.
+ */
+class Trace {
+    public:
+        static constexpr size_t RING_CAPACITY = size_t(1) << 15;
+        static constexpr int64_t NO_ARG = INT64_MIN;
+
+        /**
+         * @brief Turns recording on or off for every thread.
+         * @param isOn New state.
+         */
+        static void setEnabled(bool isOn);
+
+        /**
+         * @brief Returns whether spans are being recorded.
+         * @return true while enabled.
+         */
+        static bool isEnabled();
+
+        /**
+         * @brief Nanoseconds since the trace clock's origin.
+         * @return Current trace time.
+         */
+        static int64_t now();
+
+        /**
+         * @brief Records a finished span on the calling thread's ring.
+         * @param name Span name; must be a string literal.
+         * @param start Start time from now().
+         * @param duration Length in nanoseconds.
+         * @param arg Value shown as the span's "n" argument, or NO_ARG.
+         */
+        static void record(const char* name, int64_t start, int64_t duration,
+                           int64_t arg);
+
+        /**
+         * @brief Names the calling thread's row in the exported trace.
+         *
+         * Threads given the same name and index share one row, so a worker
+         * recreated per fetch stays on the same row across fetches.
+         *
+         * @param name Row name; must be a string literal.
+         * @param index Appended to the name unless negative.
+         */
+        static void nameThread(const char* name, int index = -1);
+
+        /**
+         * @brief Writes every recorded span as Chrome trace event JSON.
+         * @param out Stream to write to (e.g. a .json file for Perfetto).
+         * @return Number of spans written.
+         */
+        static size_t writeJson(std::ostream& out);
+
+        /**
+         * @brief Returns the spans overwritten because a ring was full.
+         * @return Dropped span count since the last clear().
+         */
+        static size_t getDropped();
+
+        /**
+         * @brief Discards every recorded span; row names are kept.
+         */
+        static void clear();
+
+    private:
+        /**
+         * @brief One finished span.
+         */
+        struct Event {
+            const char* name;
+            int64_t start;
+            int64_t duration;
+            int64_t arg;
+            uint32_t tid;
+        };
+
+        /**
+         * @brief Span storage written by one thread at a time.
+         */
+        struct Ring {
+            std::vector<Event> events;
+            size_t written = 0;
+        };
+
+        /**
+         * @brief The calling thread's ring and row; gives the ring back to
+         *   the free list when the thread exits.
+         */
+        struct Lane {
+            Ring* ring = nullptr;
+            uint32_t tid = 0;
+
+            ~Lane();
+        };
+
+        /**
+         * @brief Returns the calling thread's lane, with a ring attached.
+         */
+        static Lane& lane();
+
+        static std::atomic<bool> enabled;
+        static const std::chrono::steady_clock::time_point origin;
+
+        // guards the registry below, never the rings' contents
+        static std::mutex registryLock;
+        static std::vector<std::unique_ptr<Ring>> rings;
+        static std::vector<Ring*> freeRings;
+        static std::vector<std::string> rowNames;
+        static uint32_t nextTid;
+
+        static thread_local Lane current;
+};
+
+/**
+ * @brief Records the span from its construction to its destruction.
+ */
+class TraceScope {
+    public:
+        /**
+         * @brief Starts the span if tracing is enabled.
+         * @param name Span name; must be a string literal.
+         * @param arg Value shown as the span's "n" argument, or NO_ARG.
+         */
+        explicit TraceScope(const char* name, int64_t arg = Trace::NO_ARG);
+
+        /**
+         * @brief Records the span if it was started.
+         */
+        ~TraceScope();
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+        const char* name;
+        int64_t arg;
+        int64_t start = 0;
+        bool isActive;
+};
+
+#if defined(PATHFIND_TRACE)
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, arg) \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, int64_t(arg))
+#define TRACE_THREAD(name, index) Trace::nameThread(name, index)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, arg) ((void)0)
+#define TRACE_THREAD(name, index) ((void)0)
+#endif
+
+#endif
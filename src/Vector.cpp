@@ -3,142 +3,200 @@
 #include <stdexcept>
 #include <utility>
 
-template<typename T>
-void Vector<T>::reAlloc(size_t newCapacity) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::reAlloc(size_t newCapacity) {
 
-    T* newBlock = new T[newCapacity];
+    T* newBlock = AllocTraits::allocate(alloc, newCapacity);
+    AllocStats::onAllocate(kind, newCapacity * sizeof(T));
 
     if (newCapacity < size) {
+        for (size_t i = newCapacity; i < size; ++i) {
+            AllocTraits::destroy(alloc, data + i);
+        }
         size = newCapacity;
     }
 
     for (size_t i = 0; i < size; ++i) {
-        newBlock[i] = std::move(data[i]);
+        AllocTraits::construct(alloc, newBlock + i, std::move(data[i]));
+        AllocTraits::destroy(alloc, data + i);
     }
 
-    delete[] data;
+    if (data != nullptr) {
+        AllocTraits::deallocate(alloc, data, capacity);
+        AllocStats::onFree(kind, capacity * sizeof(T));
+        AllocStats::onReallocate(kind);
+    }
     data = newBlock;
     capacity = newCapacity;
 
     return;
 }
 
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::release() {
 
-template<typename T>
-Vector<T>::Vector() 
-    : data(nullptr), capacity(0), size(0)
-{
-    reAlloc(MINIMUM_CAP);
+    for (size_t i = 0; i < size; ++i) {
+        AllocTraits::destroy(alloc, data + i);
+    }
+
+    if (data != nullptr) {
+        AllocTraits::deallocate(alloc, data, capacity);
+        AllocStats::onFree(kind, capacity * sizeof(T));
+    }
+
+    data = nullptr;
+    capacity = 0;
+    size = 0;
+
+    return;
 }
 
-template<typename T>
-Vector<T>::Vector(size_t size) 
-    : data(new T[size]()), capacity(size), size(size)  {}
 
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector()
+    : Vector(Alloc())
+{}
 
-template<typename T>
-Vector<T>::~Vector() {
-    delete[] data;
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(const Alloc& alloc, AllocStats::Kind kind)
+    : alloc(alloc), kind(kind), data(nullptr), capacity(0), size(0)
+{
+    reAlloc(MINIMUM_CAP);
 }
 
-template<typename T>
-Vector<T>::Vector(const Vector& other)
-    : data(nullptr), capacity(other.capacity), size(other.size)
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(size_t size, const Alloc& alloc, AllocStats::Kind kind)
+    : alloc(alloc), kind(kind), data(nullptr), capacity(0), size(0)
 {
-    data = new T[capacity];
+    reAlloc(size);
+
     for (size_t i = 0; i < size; ++i) {
-        data[i] = other.data[i];
+        AllocTraits::construct(this->alloc, data + i);
     }
+    this->size = size;
 }
 
-template<typename T>
-Vector<T>::Vector(const std::vector<T>& v) {
 
-    size = v.size();
-    capacity = v.capacity();
-    data = new T[capacity];
-    std::copy(v.begin(), v.end(), data);
+template<typename T, typename Alloc>
+Vector<T, Alloc>::~Vector() {
+    release();
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(const Vector& other) {
-    
-    if (this != &other) {
-        delete[] data;
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(const Vector& other)
+    : alloc(AllocTraits::select_on_container_copy_construction(other.alloc)),
+      kind(other.kind), data(nullptr), capacity(0), size(0)
+{
+    reAlloc(other.capacity);
+    for (size_t i = 0; i < other.size; ++i) {
+        AllocTraits::construct(alloc, data + i, other.data[i]);
+    }
+    size = other.size;
+}
 
-        size = other.size;
-        capacity = other.capacity;
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(const std::vector<T>& v)
+    : data(nullptr), capacity(0), size(0)
+{
+    *this = v;
+}
+
+template<typename T, typename Alloc>
+Vector<T, Alloc>& Vector<T, Alloc>::operator=(const Vector& other) {
 
-        data = new T[capacity];
-        for (size_t i = 0; i < size; ++i) {
-            data[i] = other.data[i];
+    if (this != &other) {
+        release();
+
+        reAlloc(other.capacity);
+        for (size_t i = 0; i < other.size; ++i) {
+            AllocTraits::construct(alloc, data + i, other.data[i]);
         }
+        size = other.size;
     }
 
     return *this;
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(const std::vector<T>& v) {
-    
-    delete[] data;
+template<typename T, typename Alloc>
+Vector<T, Alloc>& Vector<T, Alloc>::operator=(const std::vector<T>& v) {
+
+    release();
+
+    reAlloc(v.capacity() > 0 ? v.capacity() : MINIMUM_CAP);
+    for (size_t i = 0; i < v.size(); ++i) {
+        AllocTraits::construct(alloc, data + i, v[i]);
+    }
     size = v.size();
-    capacity = v.capacity();
-    data = new T[capacity];
-    std::copy(v.begin(), v.end(), data);
-    
+
     return *this;
 }
 
-template<typename T>
-void Vector<T>::push_back(const T& value) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::swap(Vector& other) {
+
+    std::swap(alloc, other.alloc);
+    std::swap(kind, other.kind);
+    std::swap(data, other.data);
+    std::swap(capacity, other.capacity);
+    std::swap(size, other.size);
+
+    return;
+}
+
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::push_back(const T& value) {
 
     if (size >= capacity) {
         reAlloc((capacity == 0 ? MINIMUM_CAP : capacity) * GROW_FACTOR);
     }
 
-    data[size] = value;
+    AllocTraits::construct(alloc, data + size, value);
     ++size;
 }
 
-template<typename T>
-void Vector<T>::push_back(T&& value) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::push_back(T&& value) {
 
     if (size >= capacity) {
         reAlloc((capacity == 0 ? MINIMUM_CAP : capacity) * GROW_FACTOR);
     }
 
-    data[size] = std::move(value);
+    AllocTraits::construct(alloc, data + size, std::move(value));
     ++size;
 }
 
 
-template<typename T>
-void Vector<T>::pop_back() {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::pop_back() {
 
     if (size > 0) {
         --size;
+        AllocTraits::destroy(alloc, data + size);
     }
 
     return;
 }
 
 
-template<typename T>
-void Vector<T>::clear() {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::clear() {
+
+    for (size_t i = 0; i < size; ++i) {
+        AllocTraits::destroy(alloc, data + i);
+    }
 
     size = 0;
     return;
 }
 
-template<typename T>
-size_t Vector<T>::getSize() const {
+template<typename T, typename Alloc>
+size_t Vector<T, Alloc>::getSize() const {
     return size;
 }
 
 
-template<typename T>
-const T& Vector<T>::operator[](size_t index) const {
+template<typename T, typename Alloc>
+const T& Vector<T, Alloc>::operator[](size_t index) const {
 
     if (index >= size) {
         throw std::runtime_error("Out of bounds access");
@@ -148,8 +206,8 @@ const T& Vector<T>::operator[](size_t index) const {
 }
 
 
-template<typename T>
-T& Vector<T>::operator[](size_t index)  {
+template<typename T, typename Alloc>
+T& Vector<T, Alloc>::operator[](size_t index)  {
 
     if (index >= size) {
         throw std::runtime_error("Out of bounds access");
@@ -159,23 +217,23 @@ T& Vector<T>::operator[](size_t index)  {
 }
 
 
-template<typename T>
-T* Vector<T>::begin() {
-    return data; 
+template<typename T, typename Alloc>
+T* Vector<T, Alloc>::begin() {
+    return data;
 }
 
-template<typename T>
-T* Vector<T>::end() { 
+template<typename T, typename Alloc>
+T* Vector<T, Alloc>::end() {
     return data + size;
 }
 
-template<typename T>
-const T* Vector<T>::begin() const {
-    return data; 
+template<typename T, typename Alloc>
+const T* Vector<T, Alloc>::begin() const {
+    return data;
 }
 
-template<typename T>
-const T* Vector<T>::end() const { 
-    return data + size; 
+template<typename T, typename Alloc>
+const T* Vector<T, Alloc>::end() const {
+    return data + size;
 }
 
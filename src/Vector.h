@@ -2,22 +2,36 @@
 #define VECT_H
 
 #include <cstddef>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "AllocStats.h"
+
 
 
 /**
  * @brief A lightweight dynamic array class similar to std::vector.
+ *
+ * Storage comes from @p Alloc, so a vector can live in an Arena
+ * instead of the global heap. Only the first getSize() slots hold
+ * constructed elements. Allocations are reported to AllocStats under the
+ * kind of container the vector is storage for.
+ *
  * @tparam T Type of elements stored in the vector.
+ * @tparam Alloc Allocator used for the element storage.
  */
-template<typename T>
+template<typename T, typename Alloc = std::allocator<T>>
 class Vector {
     private:
 
+        using AllocTraits = std::allocator_traits<Alloc>;
+
         static constexpr size_t MINIMUM_CAP = 2;
-        const int GROW_FACTOR = 2;
+        static constexpr int GROW_FACTOR = 2;
 
+        Alloc alloc{};
+        AllocStats::Kind kind = AllocStats::VECTOR;
         T* data = nullptr;
         size_t capacity = 0;
         size_t size = 0;
@@ -30,17 +44,33 @@ class Vector {
      */
     void reAlloc(size_t newCapacity);
 
+    /**
+     * @brief Destroys all elements and returns the storage to the allocator.
+     */
+    void release();
+
     public:
         /**
          * @brief Default constructor. Creates an empty vector.
          */
         Vector();
 
+        /**
+         * @brief Creates an empty vector drawing memory from @p alloc.
+         * @param alloc Allocator to use for the element storage.
+         * @param kind Container the storage is accounted to in AllocStats.
+         */
+        explicit Vector(const Alloc& alloc,
+                        AllocStats::Kind kind = AllocStats::VECTOR);
+
         /**
          * @brief Constructs a vector with a given initial size.
          * @param size Number of elements to allocate.
+         * @param alloc Allocator to use for the element storage.
+         * @param kind Container the storage is accounted to in AllocStats.
          */
-        Vector(size_t size);
+        Vector(size_t size, const Alloc& alloc = Alloc(),
+               AllocStats::Kind kind = AllocStats::VECTOR);
 
         /**
          * @brief Copy constructor.
@@ -73,6 +103,16 @@ class Vector {
          */
         Vector& operator=(const std::vector<T>& v);
 
+        /**
+         * @brief Exchanges contents with another vector without copying.
+         *
+         * The allocators are exchanged too, so each block keeps being grown
+         * and freed through the allocator (and Arena) it came from.
+         *
+         * @param other The vector to swap with.
+         */
+        void swap(Vector& other);
+
         /**
          * @brief Adds a new element to the end of the vector (copy version).
          * @param value The value to add.
@@ -0,0 +1,54 @@
+#ifndef WORLD_BACKEND_H
+#define WORLD_BACKEND_H
+
+#include <mcpp/mcpp.h>
+
+/**
+ * @brief The world calls the path builders depend on.
+ *
+ * Implemented by McppBackend (a live server) and SimulatedWorld (in-memory
+ * terrain for offline, reproducible runs). Results use the same HeightMap
+ * and Chunk types and layouts as mcpp.
+ */
+class WorldBackend {
+    public:
+        virtual ~WorldBackend() = default;
+
+        /**
+         * @brief Returns the highest non-air y of every column in a region.
+         * @param loc1 One corner (y ignored).
+         * @param loc2 Opposite corner (y ignored).
+         * @return Height map of the region.
+         */
+        virtual mcpp::HeightMap getHeights(const mcpp::Coordinate& loc1,
+                                           const mcpp::Coordinate& loc2) = 0;
+
+        /**
+         * @brief Returns every block of a cuboid.
+         * @param loc1 One corner.
+         * @param loc2 Opposite corner.
+         * @return Blocks of the cuboid.
+         */
+        virtual mcpp::Chunk getBlocks(const mcpp::Coordinate& loc1,
+                                      const mcpp::Coordinate& loc2) = 0;
+
+        /**
+         * @brief Places a single block.
+         * @param loc Block position.
+         * @param blockType Block to place.
+         */
+        virtual void setBlock(const mcpp::Coordinate& loc,
+                              const mcpp::BlockType& blockType) = 0;
+
+        /**
+         * @brief Fills a cuboid with one block type.
+         * @param loc1 One corner (inclusive).
+         * @param loc2 Opposite corner (inclusive).
+         * @param blockType Block to place.
+         */
+        virtual void setBlocks(const mcpp::Coordinate& loc1,
+                               const mcpp::Coordinate& loc2,
+                               const mcpp::BlockType& blockType) = 0;
+};
+
+#endif
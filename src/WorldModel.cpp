@@ -0,0 +1,997 @@
+#include "WorldModel.h"
+
+#include <algorithm>
+#include <climits>
+#include <exception>
+
+#include "Trace.h"
+
+
+static_assert(WorldSnapshot::TILE_SIZE == WorldModel::TILE_SIZE,
+              "snapshot tiles must match cache tiles");
+
+
+WorldModel::WorldModel(ConnectionPool& pool, size_t memoryCap)
+    : pool(pool), memoryCap(memoryCap)
+{}
+
+
+WorldModel::TileRange WorldModel::tilesOf(const mcpp::Coordinate& loc1,
+                                          const mcpp::Coordinate& loc2) {
+
+    return TileRange{std::min(loc1.x, loc2.x) >> TILE_SHIFT,
+                     std::min(loc1.z, loc2.z) >> TILE_SHIFT,
+                     std::max(loc1.x, loc2.x) >> TILE_SHIFT,
+                     std::max(loc1.z, loc2.z) >> TILE_SHIFT};
+}
+
+
+int WorldModel::cellIndex(int x, int z) {
+    return (x & (TILE_SIZE - 1)) * TILE_SIZE + (z & (TILE_SIZE - 1));
+}
+
+
+size_t WorldModel::tileBytes(const Tile& tile) {
+    return sizeof(Tile) + tile.blocks.getSize() * sizeof(mcpp::BlockType);
+}
+
+
+std::vector<WorldModel::TileRange>
+WorldModel::mergeMissing(const TileRange& range, std::vector<char>& isMissing,
+                         const std::vector<SpanGroup>& groups) {
+
+    int width = range.maxZ - range.minZ + 1;
+    int height = range.maxX - range.minX + 1;
+    std::vector<TileRange> rects{};
+
+    auto missingAt = [&isMissing, width](int x, int z) -> char& {
+        return isMissing[size_t(x) * width + z];
+    };
+    auto groupAt = [&groups, width](int x, int z) -> const SpanGroup& {
+        return groups[size_t(x) * width + z];
+    };
+
+    for (int x = 0; x < height; ++x) {
+        for (int z = 0; z < width; ++z) {
+
+            if (missingAt(x, z)) {
+                const SpanGroup& group = groupAt(x, z);
+
+                int zEnd = z;
+                while (zEnd + 1 < width && missingAt(x, zEnd + 1) &&
+                       groupAt(x, zEnd + 1) == group) {
+                    ++zEnd;
+                }
+
+                // grow along x while the whole z run is missing
+                int xEnd = x;
+                bool canGrow = true;
+                while (canGrow && xEnd + 1 < height) {
+                    for (int k = z; k <= zEnd && canGrow; ++k) {
+                        canGrow = missingAt(xEnd + 1, k) != 0 &&
+                                  groupAt(xEnd + 1, k) == group;
+                    }
+                    if (canGrow) {
+                        ++xEnd;
+                    }
+                }
+
+                for (int i = x; i <= xEnd; ++i) {
+                    for (int k = z; k <= zEnd; ++k) {
+                        missingAt(i, k) = 0;
+                    }
+                }
+
+                rects.push_back(TileRange{range.minX + x, range.minZ + z,
+                                          range.minX + xEnd, range.minZ + zEnd});
+            }
+        }
+    }
+
+    return rects;
+}
+
+
+WorldModel::Tile* WorldModel::findTile(int tileX, int tileZ) {
+
+    const int* slot = tileIndex.find(mcpp::Coordinate2D(tileX, tileZ));
+
+    return (slot != nullptr) ? tiles[*slot].get() : nullptr;
+}
+
+
+void WorldModel::unlink(int slot) {
+
+    Tile& tile = *tiles[slot];
+
+    if (tile.newer != -1) {
+        tiles[tile.newer]->older = tile.older;
+    } else {
+        newest = tile.older;
+    }
+
+    if (tile.older != -1) {
+        tiles[tile.older]->newer = tile.newer;
+    } else {
+        oldest = tile.newer;
+    }
+
+    tile.newer = -1;
+    tile.older = -1;
+
+    return;
+}
+
+
+void WorldModel::pushNewest(int slot) {
+
+    Tile& tile = *tiles[slot];
+
+    tile.older = newest;
+    tile.newer = -1;
+
+    if (newest != -1) {
+        tiles[newest]->newer = slot;
+    }
+    newest = slot;
+
+    if (oldest == -1) {
+        oldest = slot;
+    }
+
+    return;
+}
+
+
+WorldModel::Tile& WorldModel::useTile(int tileX, int tileZ) {
+
+    int freeSlot = freeSlots.empty() ? int(tiles.size()) : freeSlots.back();
+
+    std::pair<int*, bool> slot =
+        tileIndex.try_emplace(mcpp::Coordinate2D(tileX, tileZ), freeSlot);
+
+    if (slot.second) {
+        if (freeSlots.empty()) {
+            tiles.push_back(nullptr);
+        } else {
+            freeSlots.pop_back();
+        }
+
+        tiles[freeSlot] = std::make_unique<Tile>();
+        tiles[freeSlot]->key = mcpp::Coordinate2D(tileX, tileZ);
+        stats.cachedBytes += sizeof(Tile);
+    }
+    else {
+        unlink(*slot.first);
+    }
+
+    pushNewest(*slot.first);
+
+    Tile& tile = *tiles[*slot.first];
+    tile.lastUse = clock;
+
+    return tile;
+}
+
+
+void WorldModel::evict() {
+
+    // tiles of the current read and tiles still being fetched are skipped,
+    // so a newer tile behind them can still be evicted
+    int slot = oldest;
+    while (stats.cachedBytes > memoryCap && slot != -1) {
+
+        Tile& tile = *tiles[slot];
+        int newer = tile.newer;
+
+        if (tile.lastUse != clock && !tile.isFetchingHeights &&
+            !tile.isFetchingBlocks) {
+
+            unlink(slot);
+            tileIndex.erase(tile.key);
+            stats.cachedBytes -= tileBytes(tile);
+            ++stats.evictions;
+
+            tiles[slot].reset();
+            freeSlots.push_back(slot);
+        }
+
+        slot = newer;
+    }
+
+    return;
+}
+
+
+void WorldModel::waitForFetches(const TileRange& range, bool isBlocks,
+                                std::unique_lock<std::mutex>& guard) {
+
+    auto isFetching = [this, &range, isBlocks]() {
+        bool found = false;
+
+        for (int tx = range.minX; tx <= range.maxX && !found; ++tx) {
+            for (int tz = range.minZ; tz <= range.maxZ && !found; ++tz) {
+                const Tile* tile = findTile(tx, tz);
+
+                found = tile != nullptr &&
+                        (isBlocks ? tile->isFetchingBlocks : tile->isFetchingHeights);
+            }
+        }
+
+        return found;
+    };
+
+    fetchDone.wait(guard, [&isFetching]() { return !isFetching(); });
+
+    return;
+}
+
+
+uint64_t WorldModel::beginFetch() {
+
+    // the server may not have the writes from the oldest unforwarded one on
+    uint64_t since = nextWrite;
+    for (size_t i = 0; i < writeLog.size() && since == nextWrite; ++i) {
+        if (!writeLog[i].isForwarded) {
+            since = writeLog[i].seq;
+        }
+    }
+
+    fetchesSince.push_back(since);
+
+    return since;
+}
+
+
+void WorldModel::endFetch(uint64_t since) {
+
+    fetchesSince.erase(std::find(fetchesSince.begin(), fetchesSince.end(), since));
+    pruneWrites();
+
+    return;
+}
+
+
+void WorldModel::pruneWrites() {
+
+    uint64_t oldest = nextWrite;
+    for (uint64_t other : fetchesSince) {
+        oldest = std::min(oldest, other);
+    }
+
+    size_t stale = 0;
+    while (stale < writeLog.size() && writeLog[stale].isForwarded &&
+           writeLog[stale].seq < oldest) {
+        ++stale;
+    }
+    writeLog.erase(writeLog.begin(), writeLog.begin() + stale);
+
+    return;
+}
+
+
+void WorldModel::replayWrites(const TileRange& rect, uint64_t since) {
+
+    int rectMinX = rect.minX * TILE_SIZE;
+    int rectMinZ = rect.minZ * TILE_SIZE;
+    int rectMaxX = (rect.maxX + 1) * TILE_SIZE - 1;
+    int rectMaxZ = (rect.maxZ + 1) * TILE_SIZE - 1;
+
+    for (const LoggedWrite& write : writeLog) {
+        if (write.seq >= since) {
+            mcpp::Coordinate lo(std::max(write.lo.x, rectMinX), write.lo.y,
+                                std::max(write.lo.z, rectMinZ));
+            mcpp::Coordinate hi(std::min(write.hi.x, rectMaxX), write.hi.y,
+                                std::min(write.hi.z, rectMaxZ));
+
+            if (lo.x <= hi.x && lo.z <= hi.z) {
+                applyWrites(lo, hi, write.blockType);
+            }
+        }
+    }
+
+    return;
+}
+
+
+void WorldModel::fetchHeights(const TileRange& range, std::unique_lock<std::mutex>& guard) {
+
+    bool isFirstPass = true;
+    bool isDone = false;
+
+    // tiles may be evicted or invalidated while unlocked, so each pass
+    // checks the whole range again
+    while (!isDone) {
+        waitForFetches(range, false, guard);
+
+        std::vector<char> isMissing{};
+        std::vector<SpanGroup> groups{};
+
+        for (int tx = range.minX; tx <= range.maxX; ++tx) {
+            for (int tz = range.minZ; tz <= range.maxZ; ++tz) {
+                bool missing = !useTile(tx, tz).hasHeights;
+
+                isMissing.push_back(missing ? 1 : 0);
+                groups.push_back(SpanGroup(0, 0));
+                if (isFirstPass && missing) {
+                    ++stats.misses;
+                } else if (isFirstPass) {
+                    ++stats.hits;
+                }
+            }
+        }
+
+        std::vector<TileRange> rects = mergeMissing(range, isMissing, groups);
+        isFirstPass = false;
+        isDone = rects.empty();
+
+        if (!isDone) {
+            fetchHeightRects(rects, guard);
+        }
+    }
+
+    return;
+}
+
+
+void WorldModel::fetchHeightRects(const std::vector<TileRange>& rects,
+                                  std::unique_lock<std::mutex>& guard) {
+
+    for (const TileRange& rect : rects) {
+        for (int tx = rect.minX; tx <= rect.maxX; ++tx) {
+            for (int tz = rect.minZ; tz <= rect.maxZ; ++tz) {
+                findTile(tx, tz)->isFetchingHeights = true;
+            }
+        }
+    }
+
+    std::vector<mcpp::HeightMap> results{};
+    std::exception_ptr failure = nullptr;
+    uint64_t since = beginFetch();
+
+    guard.unlock();
+    try {
+        for (const TileRange& rect : rects) {
+            results.push_back(pool.getHeights(
+                mcpp::Coordinate(rect.minX * TILE_SIZE, 0, rect.minZ * TILE_SIZE),
+                mcpp::Coordinate((rect.maxX + 1) * TILE_SIZE - 1, 0,
+                                 (rect.maxZ + 1) * TILE_SIZE - 1)));
+        }
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    guard.lock();
+
+    for (size_t r = 0; r < results.size(); ++r) {
+        const TileRange& rect = rects[r];
+        const mcpp::HeightMap& fetched = results[r];
+
+        ++stats.fetches;
+        stats.bytesFetched += size_t(fetched.x_len()) * fetched.z_len() * sizeof(int);
+
+        for (int tx = rect.minX; tx <= rect.maxX; ++tx) {
+            for (int tz = rect.minZ; tz <= rect.maxZ; ++tz) {
+                Tile& tile = *findTile(tx, tz);
+                int offX = (tx - rect.minX) * TILE_SIZE;
+                int offZ = (tz - rect.minZ) * TILE_SIZE;
+
+                for (int x = 0; x < TILE_SIZE; ++x) {
+                    for (int z = 0; z < TILE_SIZE; ++z) {
+                        tile.heights[x * TILE_SIZE + z] = fetched.get(offX + x, offZ + z);
+                    }
+                }
+                tile.hasHeights = true;
+            }
+        }
+
+        replayWrites(rect, since);
+    }
+
+    for (const TileRange& rect : rects) {
+        for (int tx = rect.minX; tx <= rect.maxX; ++tx) {
+            for (int tz = rect.minZ; tz <= rect.maxZ; ++tz) {
+                findTile(tx, tz)->isFetchingHeights = false;
+            }
+        }
+    }
+
+    endFetch(since);
+    fetchDone.notify_all();
+
+    if (failure != nullptr) {
+        std::rethrow_exception(failure);
+    }
+
+    return;
+}
+
+
+void WorldModel::fetchBlocks(const TileRange& range, const std::vector<YSpan>& spans,
+                             std::unique_lock<std::mutex>& guard) {
+
+    int rangeWidth = range.maxZ - range.minZ + 1;
+
+    bool isFirstPass = true;
+    bool isDone = false;
+
+    // tiles may be evicted or invalidated while unlocked, so each pass
+    // checks the whole range again
+    while (!isDone) {
+        waitForFetches(range, true, guard);
+
+        std::vector<char> isMissing{};
+        std::vector<SpanGroup> groups{};
+        std::vector<YSpan> wanted{};
+
+        size_t i = 0;
+        for (int tx = range.minX; tx <= range.maxX; ++tx) {
+            for (int tz = range.minZ; tz <= range.maxZ; ++tz) {
+                Tile& tile = useTile(tx, tz);
+                YSpan need = spans[i++];
+
+                bool isCovered = tile.hasBlocks && tile.yMin <= need.min &&
+                                 tile.yMax >= need.max;
+
+                // a tile only ever grows its y span
+                if (!isCovered && tile.hasBlocks) {
+                    need.min = std::min(need.min, tile.yMin);
+                    need.max = std::max(need.max, tile.yMax);
+                }
+
+                isMissing.push_back(isCovered ? 0 : 1);
+                groups.push_back(SpanGroup(need.min >> SPAN_BUCKET_SHIFT,
+                                           need.max >> SPAN_BUCKET_SHIFT));
+                wanted.push_back(need);
+
+                if (isFirstPass && isCovered) {
+                    ++stats.hits;
+                } else if (isFirstPass) {
+                    ++stats.misses;
+                }
+            }
+        }
+
+        std::vector<TileRange> rects = mergeMissing(range, isMissing, groups);
+        std::vector<YSpan> rectSpans{};
+
+        for (const TileRange& rect : rects) {
+
+            // one request covers the union of the rectangle's spans
+            YSpan span = wanted[size_t(rect.minX - range.minX) * rangeWidth +
+                                (rect.minZ - range.minZ)];
+            for (int tx = rect.minX; tx <= rect.maxX; ++tx) {
+                for (int tz = rect.minZ; tz <= rect.maxZ; ++tz) {
+                    const YSpan& need = wanted[size_t(tx - range.minX) * rangeWidth +
+                                               (tz - range.minZ)];
+                    span.min = std::min(span.min, need.min);
+                    span.max = std::max(span.max, need.max);
+                }
+            }
+
+            rectSpans.push_back(span);
+        }
+
+        isFirstPass = false;
+        isDone = rects.empty();
+
+        if (!isDone) {
+            fetchBlockRects(rects, rectSpans, guard);
+        }
+    }
+
+    return;
+}
+
+
+void WorldModel::fetchBlockRects(const std::vector<TileRange>& rects,
+                                 const std::vector<YSpan>& spans,
+                                 std::unique_lock<std::mutex>& guard) {
+
+    size_t layer = size_t(TILE_SIZE) * TILE_SIZE;
+
+    for (const TileRange& rect : rects) {
+        for (int tx = rect.minX; tx <= rect.maxX; ++tx) {
+            for (int tz = rect.minZ; tz <= rect.maxZ; ++tz) {
+                findTile(tx, tz)->isFetchingBlocks = true;
+            }
+        }
+    }
+
+    std::vector<mcpp::Chunk> results{};
+    std::exception_ptr failure = nullptr;
+    uint64_t since = beginFetch();
+
+    guard.unlock();
+    try {
+        for (size_t r = 0; r < rects.size(); ++r) {
+            const TileRange& rect = rects[r];
+
+            results.push_back(pool.getBlocks(
+                mcpp::Coordinate(rect.minX * TILE_SIZE, spans[r].min, rect.minZ * TILE_SIZE),
+                mcpp::Coordinate((rect.maxX + 1) * TILE_SIZE - 1, spans[r].max,
+                                 (rect.maxZ + 1) * TILE_SIZE - 1)));
+        }
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    guard.lock();
+
+    for (size_t r = 0; r < results.size(); ++r) {
+        const TileRange& rect = rects[r];
+        const mcpp::Chunk& fetched = results[r];
+        int ySpan = spans[r].max - spans[r].min + 1;
+
+        ++stats.fetches;
+        stats.bytesFetched += size_t(fetched.x_len()) * fetched.y_len() *
+                              fetched.z_len() * sizeof(mcpp::BlockType);
+
+        for (int tx = rect.minX; tx <= rect.maxX; ++tx) {
+            for (int tz = rect.minZ; tz <= rect.maxZ; ++tz) {
+                Tile& tile = *findTile(tx, tz);
+                int offX = (tx - rect.minX) * TILE_SIZE;
+                int offZ = (tz - rect.minZ) * TILE_SIZE;
+
+                Vector<mcpp::BlockType> blocks(size_t(ySpan) * layer);
+                for (int y = 0; y < ySpan; ++y) {
+                    for (int x = 0; x < TILE_SIZE; ++x) {
+                        for (int z = 0; z < TILE_SIZE; ++z) {
+                            blocks[size_t(y) * layer + x * TILE_SIZE + z] =
+                                fetched.get(offX + x, y, offZ + z);
+                        }
+                    }
+                }
+
+                stats.cachedBytes -= tileBytes(tile);
+                tile.blocks.swap(blocks);
+                stats.cachedBytes += tileBytes(tile);
+
+                tile.yMin = spans[r].min;
+                tile.yMax = spans[r].max;
+                tile.hasBlocks = true;
+            }
+        }
+
+        replayWrites(rect, since);
+    }
+
+    for (const TileRange& rect : rects) {
+        for (int tx = rect.minX; tx <= rect.maxX; ++tx) {
+            for (int tz = rect.minZ; tz <= rect.maxZ; ++tz) {
+                findTile(tx, tz)->isFetchingBlocks = false;
+            }
+        }
+    }
+
+    endFetch(since);
+    fetchDone.notify_all();
+
+    if (failure != nullptr) {
+        std::rethrow_exception(failure);
+    }
+
+    return;
+}
+
+
+mcpp::HeightMap WorldModel::getHeights(const mcpp::Coordinate& loc1,
+                                       const mcpp::Coordinate& loc2) {
+
+    TRACE_SCOPE("WorldModel::getHeights");
+
+    mcpp::Coordinate lo(std::min(loc1.x, loc2.x), 0, std::min(loc1.z, loc2.z));
+    mcpp::Coordinate hi(std::max(loc1.x, loc2.x), 0, std::max(loc1.z, loc2.z));
+
+    int xLen = hi.x - lo.x + 1;
+    int zLen = hi.z - lo.z + 1;
+    std::vector<int> heights(size_t(xLen) * zLen);
+
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        ++clock;
+        fetchHeights(tilesOf(lo, hi), guard);
+
+        // same layout as mcpp: index = x * zLen + z
+        for (int x = 0; x < xLen; ++x) {
+            for (int z = 0; z < zLen; ++z) {
+                int worldX = lo.x + x;
+                int worldZ = lo.z + z;
+                const Tile* tile = findTile(worldX >> TILE_SHIFT, worldZ >> TILE_SHIFT);
+
+                heights[size_t(x) * zLen + z] = tile->heights[cellIndex(worldX, worldZ)];
+            }
+        }
+
+        evict();
+    }
+
+    return mcpp::HeightMap(lo, hi, heights);
+}
+
+
+mcpp::Chunk WorldModel::getBlocks(const mcpp::Coordinate& loc1,
+                                  const mcpp::Coordinate& loc2) {
+
+    TRACE_SCOPE("WorldModel::getBlocks");
+
+    mcpp::Coordinate lo(std::min(loc1.x, loc2.x), std::min(loc1.y, loc2.y),
+                        std::min(loc1.z, loc2.z));
+    mcpp::Coordinate hi(std::max(loc1.x, loc2.x), std::max(loc1.y, loc2.y),
+                        std::max(loc1.z, loc2.z));
+
+    int xLen = hi.x - lo.x + 1;
+    int yLen = hi.y - lo.y + 1;
+    int zLen = hi.z - lo.z + 1;
+    std::vector<mcpp::BlockType> blocks(size_t(xLen) * yLen * zLen);
+
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        ++clock;
+
+        TileRange range = tilesOf(lo, hi);
+        size_t tileCount = size_t(range.maxX - range.minX + 1) *
+                           (range.maxZ - range.minZ + 1);
+        fetchBlocks(range, std::vector<YSpan>(tileCount, YSpan{lo.y, hi.y}), guard);
+
+        // same layout as mcpp: index = y * xLen * zLen + x * zLen + z
+        for (int x = 0; x < xLen; ++x) {
+            for (int z = 0; z < zLen; ++z) {
+                int worldX = lo.x + x;
+                int worldZ = lo.z + z;
+                const Tile* tile = findTile(worldX >> TILE_SHIFT, worldZ >> TILE_SHIFT);
+
+                const mcpp::BlockType* column = tile->blocks.begin() +
+                    size_t(lo.y - tile->yMin) * TILE_SIZE * TILE_SIZE +
+                    cellIndex(worldX, worldZ);
+
+                for (int y = 0; y < yLen; ++y) {
+                    blocks[(size_t(y) * xLen + x) * zLen + z] =
+                        column[size_t(y) * TILE_SIZE * TILE_SIZE];
+                }
+            }
+        }
+
+        evict();
+    }
+
+    return mcpp::Chunk(lo, hi, blocks);
+}
+
+
+SurfaceSlab WorldModel::getSurface(const mcpp::HeightMap& heights,
+                                   int below, int above) {
+
+    TRACE_SCOPE("WorldModel::getSurface");
+
+    SurfaceSlab slab(heights, below, above);
+
+    mcpp::Coordinate2D base = slab.base_pt();
+    int xLen = slab.x_len();
+    int zLen = slab.z_len();
+
+    TileRange range = tilesOf(mcpp::Coordinate(base.x, 0, base.z),
+                              mcpp::Coordinate(base.x + xLen - 1, 0, base.z + zLen - 1));
+    int rangeWidth = range.maxZ - range.minZ + 1;
+
+    // each tile needs the span of the slab columns that fall inside it
+    std::vector<YSpan> spans(size_t(range.maxX - range.minX + 1) * rangeWidth,
+                             YSpan{INT_MAX, INT_MIN});
+    for (int x = 0; x < xLen; ++x) {
+        for (int z = 0; z < zLen; ++z) {
+            mcpp::Coordinate2D column(base.x + x, base.z + z);
+            YSpan& span = spans[size_t((column.x >> TILE_SHIFT) - range.minX) * rangeWidth +
+                                ((column.z >> TILE_SHIFT) - range.minZ)];
+
+            span.min = std::min(span.min, slab.bottomAt(column));
+            span.max = std::max(span.max, slab.topAt(column));
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        ++clock;
+        fetchBlocks(range, spans, guard);
+
+        for (int x = 0; x < xLen; ++x) {
+            for (int z = 0; z < zLen; ++z) {
+                int worldX = base.x + x;
+                int worldZ = base.z + z;
+                const Tile* tile = findTile(worldX >> TILE_SHIFT, worldZ >> TILE_SHIFT);
+
+                const mcpp::BlockType* column = tile->blocks.begin() +
+                    cellIndex(worldX, worldZ);
+                int top = slab.topAt(mcpp::Coordinate2D(worldX, worldZ));
+
+                for (int y = slab.bottomAt(mcpp::Coordinate2D(worldX, worldZ)); y <= top; ++y) {
+                    slab.set(mcpp::Coordinate(worldX, y, worldZ),
+                             column[size_t(y - tile->yMin) * TILE_SIZE * TILE_SIZE]);
+                }
+            }
+        }
+
+        evict();
+    }
+
+    return slab;
+}
+
+
+void WorldModel::prefetch(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2) {
+
+    TRACE_SCOPE("WorldModel::prefetch");
+
+    std::unique_lock<std::mutex> guard(lock);
+
+    TileRange range = tilesOf(loc1, loc2);
+
+    ++clock;
+    fetchHeights(range, guard);
+
+    size_t tileCount = size_t(range.maxX - range.minX + 1) *
+                       (range.maxZ - range.minZ + 1);
+    YSpan span{std::min(loc1.y, loc2.y), std::max(loc1.y, loc2.y)};
+    fetchBlocks(range, std::vector<YSpan>(tileCount, span), guard);
+
+    return;
+}
+
+
+void WorldModel::applyWrite(int x, int y, int z, const mcpp::BlockType& blockType) {
+
+    Tile* tile = findTile(x >> TILE_SHIFT, z >> TILE_SHIFT);
+
+    if (tile != nullptr) {
+        int cell = cellIndex(x, z);
+        size_t layer = size_t(TILE_SIZE) * TILE_SIZE;
+
+        bool isInBlocks = tile->hasBlocks && y >= tile->yMin && y <= tile->yMax;
+        if (isInBlocks) {
+            tile->blocks[size_t(y - tile->yMin) * layer + cell] = blockType;
+        }
+
+        if (tile->hasHeights) {
+            int& height = tile->heights[cell];
+
+            if (blockType != mcpp::Blocks::AIR && y > height) {
+                height = y;
+            }
+            else if (blockType == mcpp::Blocks::AIR && y == height) {
+
+                // the top was removed; find the next block below it
+                int below = y - 1;
+                bool isKnown = tile->hasBlocks && y <= tile->yMax;
+                while (isKnown && below >= tile->yMin &&
+                       tile->blocks[size_t(below - tile->yMin) * layer + cell] ==
+                           mcpp::Blocks::AIR) {
+                    --below;
+                }
+
+                if (isKnown && below >= tile->yMin) {
+                    height = below;
+                }
+                else {
+                    // cannot tell locally; refetch the tile's heights later
+                    tile->hasHeights = false;
+                }
+            }
+        }
+    }
+
+    return;
+}
+
+
+void WorldModel::applyWrites(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2,
+                             const mcpp::BlockType& blockType) {
+
+    // bottom-up, so removing a column top sees the blocks below it
+    for (int y = std::min(loc1.y, loc2.y); y <= std::max(loc1.y, loc2.y); ++y) {
+        for (int x = std::min(loc1.x, loc2.x); x <= std::max(loc1.x, loc2.x); ++x) {
+            for (int z = std::min(loc1.z, loc2.z); z <= std::max(loc1.z, loc2.z); ++z) {
+                applyWrite(x, y, z, blockType);
+            }
+        }
+    }
+
+    return;
+}
+
+
+uint64_t WorldModel::logWrite(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2,
+                              const mcpp::BlockType& blockType) {
+
+    mcpp::Coordinate lo(std::min(loc1.x, loc2.x), std::min(loc1.y, loc2.y),
+                        std::min(loc1.z, loc2.z));
+    mcpp::Coordinate hi(std::max(loc1.x, loc2.x), std::max(loc1.y, loc2.y),
+                        std::max(loc1.z, loc2.z));
+
+    writeLog.push_back(LoggedWrite{lo, hi, blockType, nextWrite, false});
+
+    return nextWrite++;
+}
+
+
+void WorldModel::forwardWrite(uint64_t seq, const mcpp::Coordinate& loc1,
+                              const mcpp::Coordinate& loc2,
+                              const mcpp::BlockType& blockType, bool isSingle) {
+
+    std::exception_ptr failure = nullptr;
+
+    {
+        std::unique_lock<std::mutex> writing(writeLock);
+
+        // the server must end up with the same last write as the cache
+        writeTurn.wait(writing, [this, seq]() { return nextForward == seq; });
+
+        try {
+            if (isSingle) {
+                pool.writer().setBlock(loc1, blockType);
+            }
+            else {
+                pool.writer().setBlocks(loc1, loc2, blockType);
+            }
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        ++nextForward;
+    }
+    writeTurn.notify_all();
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (LoggedWrite& write : writeLog) {
+            if (write.seq == seq) {
+                write.isForwarded = true;
+            }
+        }
+        pruneWrites();
+    }
+
+    if (failure != nullptr) {
+        std::rethrow_exception(failure);
+    }
+
+    return;
+}
+
+
+void WorldModel::setBlock(const mcpp::Coordinate& loc,
+                          const mcpp::BlockType& blockType) {
+
+    uint64_t seq = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        applyWrites(loc, loc, blockType);
+        seq = logWrite(loc, loc, blockType);
+    }
+
+    forwardWrite(seq, loc, loc, blockType, true);
+
+    return;
+}
+
+
+void WorldModel::setBlocks(const mcpp::Coordinate& loc1,
+                           const mcpp::Coordinate& loc2,
+                           const mcpp::BlockType& blockType) {
+
+    uint64_t seq = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        applyWrites(loc1, loc2, blockType);
+        seq = logWrite(loc1, loc2, blockType);
+    }
+
+    forwardWrite(seq, loc1, loc2, blockType, false);
+
+    return;
+}
+
+
+void WorldModel::invalidate(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2) {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    TileRange range = tilesOf(loc1, loc2);
+
+    for (int tx = range.minX; tx <= range.maxX; ++tx) {
+        for (int tz = range.minZ; tz <= range.maxZ; ++tz) {
+            Tile* tile = findTile(tx, tz);
+
+            if (tile != nullptr) {
+                stats.cachedBytes -= tileBytes(*tile);
+
+                tile->hasHeights = false;
+                tile->hasBlocks = false;
+                Vector<mcpp::BlockType>().swap(tile->blocks);
+
+                stats.cachedBytes += tileBytes(*tile);
+            }
+        }
+    }
+
+    return;
+}
+
+
+size_t WorldModel::load(const WorldSnapshot& snapshot) {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    const size_t COLUMNS = size_t(TILE_SIZE) * TILE_SIZE;
+
+    for (size_t i = 0; i < snapshot.getTileCount(); ++i) {
+        WorldSnapshot::TileView view = snapshot.tileAt(i);
+        Tile& tile = useTile(view.key.x, view.key.z);
+
+        stats.cachedBytes -= tileBytes(tile);
+
+        tile.hasHeights = view.heights != nullptr;
+        if (tile.hasHeights) {
+            std::copy(view.heights, view.heights + COLUMNS, tile.heights);
+        }
+
+        tile.hasBlocks = view.blocks != nullptr;
+        Vector<mcpp::BlockType>().swap(tile.blocks);
+        if (tile.hasBlocks) {
+            size_t count = size_t(view.yMax - view.yMin + 1) * COLUMNS;
+
+            tile.yMin = view.yMin;
+            tile.yMax = view.yMax;
+            Vector<mcpp::BlockType>(count).swap(tile.blocks);
+            std::copy(view.blocks, view.blocks + count, tile.blocks.begin());
+        }
+
+        stats.cachedBytes += tileBytes(tile);
+    }
+
+    // loaded tiles are not in use by any read, so the cap applies to them
+    ++clock;
+    evict();
+
+    return snapshot.getTileCount();
+}
+
+
+void WorldModel::save(const std::string& path) const {
+
+    std::vector<WorldSnapshot::TileView> views{};
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (const std::unique_ptr<Tile>& tile : tiles) {
+        if (tile != nullptr && (tile->hasHeights || tile->hasBlocks)) {
+            WorldSnapshot::TileView view{tile->key, nullptr, nullptr,
+                                         tile->yMin, tile->yMax};
+
+            if (tile->hasHeights) {
+                view.heights = tile->heights;
+            }
+            if (tile->hasBlocks) {
+                view.blocks = tile->blocks.begin();
+            }
+
+            views.push_back(view);
+        }
+    }
+
+    WorldSnapshot::save(path, views);
+
+    return;
+}
+
+
+WorldModel::Stats WorldModel::getStats() const {
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    return stats;
+}
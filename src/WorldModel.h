@@ -0,0 +1,377 @@
+#ifndef WORLD_MODEL_H
+#define WORLD_MODEL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <mcpp/mcpp.h>
+
+#include "WorldBackend.h"
+#include "ConnectionPool.h"
+#include "SurfaceSlab.h"
+#include "WorldSnapshot.h"
+#include "Vector.h"
+#include "FlatMap.h"
+#include "Hash.h"
+
+/**
+ * @brief A local, write-back cache of the parts of the world we have read.
+ *
+ * Heights and blocks are cached in 16x16 column tiles aligned to world
+ * chunks. A read is assembled from the tiles it covers; tiles that are
+ * missing (for blocks: or do not cover the requested y range) are merged
+ * into a few rectangles and only those are fetched through the pool.
+ *
+ * Our own writes are applied to the cached tiles and then forwarded to the
+ * pool's writer, so the cache never has to be refetched to see them.
+ * Regions changed by someone else can be dropped with invalidate().
+ *
+ * When the cached data exceeds the memory cap, the least recently used
+ * tiles are evicted, skipping those the current read uses or a fetch is
+ * filling. Evicting is safe since a tile fetched again gets any write not
+ * yet forwarded replayed.
+ *
+ * Thread safe. The lock is released while a fetch or a write waits on the
+ * server, so reads and writes of other regions go on meanwhile; a read
+ * needing tiles that are being fetched waits for that fetch instead of
+ * repeating it. Writes are forwarded in the order they were applied, and
+ * until a write has been forwarded and no fetch that may have missed it is
+ * out, it is kept in a log and applied again on top of fetched tiles.
+ */
+class WorldModel : public WorldBackend {
+    public:
+        static constexpr int TILE_SHIFT = 4;
+        static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+        static constexpr size_t DEFAULT_MEMORY_CAP = size_t(256) * 1024 * 1024;
+
+        /**
+         * @brief Cache counters. Hits and misses count tiles per read.
+         */
+        struct Stats {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t fetches = 0;
+            size_t bytesFetched = 0;
+            size_t evictions = 0;
+            size_t cachedBytes = 0;
+        };
+
+        /**
+         * @brief Creates an empty cache in front of @p pool.
+         * @param pool Connections used for fetches and writes; must outlive the model.
+         * @param memoryCap Bytes of tile data to keep before evicting.
+         */
+        explicit WorldModel(ConnectionPool& pool,
+                            size_t memoryCap = DEFAULT_MEMORY_CAP);
+
+        WorldModel(const WorldModel&) = delete;
+        WorldModel& operator=(const WorldModel&) = delete;
+
+        mcpp::HeightMap getHeights(const mcpp::Coordinate& loc1,
+                                   const mcpp::Coordinate& loc2) override;
+
+        mcpp::Chunk getBlocks(const mcpp::Coordinate& loc1,
+                              const mcpp::Coordinate& loc2) override;
+
+        /**
+         * @brief Returns the blocks around the surface of a region.
+         *
+         * Tiles only need (and fetch) the y span between their lowest
+         * surface minus @p below and highest surface plus @p above, which
+         * is usually a fraction of a padded cuboid.
+         *
+         * @param heights Surface heights of the region (e.g. from getHeights).
+         * @param below Blocks kept below the surface.
+         * @param above Blocks kept above the surface.
+         * @return Slab of the region.
+         */
+        SurfaceSlab getSurface(const mcpp::HeightMap& heights,
+                               int below = SurfaceSlab::DEFAULT_BELOW,
+                               int above = SurfaceSlab::DEFAULT_ABOVE);
+
+        void setBlock(const mcpp::Coordinate& loc,
+                      const mcpp::BlockType& blockType) override;
+
+        void setBlocks(const mcpp::Coordinate& loc1,
+                       const mcpp::Coordinate& loc2,
+                       const mcpp::BlockType& blockType) override;
+
+        /**
+         * @brief Loads the heights and blocks of a whole region up front.
+         *
+         * Fetches whatever of the cuboid is not cached yet (the pool splits
+         * it into parallel tiles), so later reads inside it are served from
+         * memory. Tiles beyond the memory cap are evicted on later reads.
+         *
+         * @param loc1 One corner.
+         * @param loc2 Opposite corner.
+         */
+        void prefetch(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2);
+
+        /**
+         * @brief Forgets every tile overlapping a region (y ignored).
+         * @param loc1 One corner.
+         * @param loc2 Opposite corner.
+         */
+        void invalidate(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2);
+
+        /**
+         * @brief Fills the cache from a snapshot, replacing cached tiles.
+         *
+         * Nothing is checked against the server: changes made since the
+         * snapshot was saved are not seen until the region is invalidated.
+         *
+         * @param snapshot Saved tiles.
+         * @return Number of tiles loaded.
+         */
+        size_t load(const WorldSnapshot& snapshot);
+
+        /**
+         * @brief Saves every cached tile, our writes included, as a snapshot.
+         * @param path File to create or replace.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        void save(const std::string& path) const;
+
+        /**
+         * @brief Returns the cache counters.
+         * @return Copy of the statistics.
+         */
+        Stats getStats() const;
+
+    private:
+        /**
+         * @brief Cached data of one 16x16 column; heights and blocks are
+         *   filled independently.
+         */
+        struct Tile {
+            mcpp::Coordinate2D key{};
+
+            bool hasHeights = false;
+            int heights[TILE_SIZE * TILE_SIZE] = {};
+
+            // blocks of [yMin, yMax]; index = (y - yMin) * 256 + x * 16 + z
+            bool hasBlocks = false;
+            int yMin = 0;
+            int yMax = -1;
+            Vector<mcpp::BlockType> blocks{};
+
+            // set while a fetch of the tile's heights or blocks is out
+            bool isFetchingHeights = false;
+            bool isFetchingBlocks = false;
+
+            // recency list links (slot indices, -1 for none) and last read
+            int newer = -1;
+            int older = -1;
+            uint64_t lastUse = 0;
+        };
+
+        /**
+         * @brief Inclusive range of tile coordinates.
+         */
+        struct TileRange {
+            int minX;
+            int minZ;
+            int maxX;
+            int maxZ;
+        };
+
+        /**
+         * @brief Inclusive y range of blocks a tile must hold.
+         */
+        struct YSpan {
+            int min;
+            int max;
+        };
+
+        /**
+         * @brief One of our writes that a fetch may not have seen.
+         */
+        struct LoggedWrite {
+            mcpp::Coordinate lo;
+            mcpp::Coordinate hi;
+            mcpp::BlockType blockType;
+            uint64_t seq;
+            bool isForwarded;
+        };
+
+        // tiles whose spans fall in different buckets are fetched apart,
+        // so one deep tile does not widen a whole merged request
+        static constexpr int SPAN_BUCKET_SHIFT = 3;
+
+        // bottom and top bucket of a tile's span
+        using SpanGroup = std::pair<int, int>;
+
+        static TileRange tilesOf(const mcpp::Coordinate& loc1,
+                                 const mcpp::Coordinate& loc2);
+
+        /**
+         * @brief Index of (x, z) inside its tile.
+         */
+        static int cellIndex(int x, int z);
+
+        /**
+         * @brief Covers the flagged tiles of @p range with few rectangles.
+         * @param range Tiles considered.
+         * @param isMissing One flag per tile, x-major over @p range.
+         * @param groups One group per tile; a rectangle never mixes groups.
+         * @return Disjoint rectangles covering exactly the flagged tiles.
+         */
+        static std::vector<TileRange> mergeMissing(const TileRange& range,
+                                                   std::vector<char>& isMissing,
+                                                   const std::vector<SpanGroup>& groups);
+
+        /**
+         * @brief Memory held by a tile.
+         */
+        static size_t tileBytes(const Tile& tile);
+
+        Tile* findTile(int tileX, int tileZ);
+
+        /**
+         * @brief Returns the tile at (tileX, tileZ), creating it if needed,
+         *   and marks it as used by the current read.
+         */
+        Tile& useTile(int tileX, int tileZ);
+
+        /**
+         * @brief Fetches heights for every tile of @p range lacking them.
+         *
+         * Unlocks @p guard around the server round trips; on return the
+         * lock is held and every tile of @p range has heights.
+         */
+        void fetchHeights(const TileRange& range, std::unique_lock<std::mutex>& guard);
+
+        /**
+         * @brief Fetches blocks for every tile of @p range not covering its span.
+         *
+         * Unlocks @p guard around the server round trips; on return the
+         * lock is held and every tile of @p range covers its span.
+         *
+         * @param range Tiles considered.
+         * @param spans Required y span per tile, x-major over @p range.
+         * @param guard Holds the lock on entry.
+         */
+        void fetchBlocks(const TileRange& range, const std::vector<YSpan>& spans,
+                         std::unique_lock<std::mutex>& guard);
+
+        /**
+         * @brief Fetches the heights of @p rects, unlocking @p guard while
+         *   the requests are out.
+         */
+        void fetchHeightRects(const std::vector<TileRange>& rects,
+                              std::unique_lock<std::mutex>& guard);
+
+        /**
+         * @brief Fetches the blocks of @p rects, each over its span in
+         *   @p spans, unlocking @p guard while the requests are out.
+         */
+        void fetchBlockRects(const std::vector<TileRange>& rects,
+                             const std::vector<YSpan>& spans,
+                             std::unique_lock<std::mutex>& guard);
+
+        /**
+         * @brief Waits until no tile of @p range has a fetch of the given
+         *   kind out.
+         */
+        void waitForFetches(const TileRange& range, bool isBlocks,
+                            std::unique_lock<std::mutex>& guard);
+
+        /**
+         * @brief Registers a fetch about to go out.
+         * @return Sequence number of the first write it may not see.
+         */
+        uint64_t beginFetch();
+
+        /**
+         * @brief Unregisters a fetch and drops the logged writes no longer
+         *   needed.
+         */
+        void endFetch(uint64_t since);
+
+        /**
+         * @brief Drops the forwarded writes that every fetch still out has
+         *   seen.
+         */
+        void pruneWrites();
+
+        /**
+         * @brief Applies the logged writes from @p since on to the tiles of
+         *   @p rect again.
+         */
+        void replayWrites(const TileRange& rect, uint64_t since);
+
+        /**
+         * @brief Applies one of our writes to every cell of a cuboid.
+         */
+        void applyWrites(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2,
+                         const mcpp::BlockType& blockType);
+
+        /**
+         * @brief Logs a write for replay until it has been forwarded.
+         * @return Sequence number of the write.
+         */
+        uint64_t logWrite(const mcpp::Coordinate& loc1, const mcpp::Coordinate& loc2,
+                          const mcpp::BlockType& blockType);
+
+        /**
+         * @brief Sends a logged write to the pool's writer once every
+         *   earlier write has been sent, without holding the cache lock.
+         * @param seq Sequence number from logWrite().
+         * @param loc1 One corner.
+         * @param loc2 Opposite corner; ignored if @p isSingle.
+         * @param blockType Block written.
+         * @param isSingle Forward as setBlock instead of setBlocks.
+         */
+        void forwardWrite(uint64_t seq, const mcpp::Coordinate& loc1,
+                          const mcpp::Coordinate& loc2,
+                          const mcpp::BlockType& blockType, bool isSingle);
+
+        /**
+         * @brief Applies one of our writes to the cached tiles.
+         */
+        void applyWrite(int x, int y, int z, const mcpp::BlockType& blockType);
+
+        void unlink(int slot);
+        void pushNewest(int slot);
+
+        /**
+         * @brief Evicts least recently used tiles until under the cap,
+         *   skipping the tiles of the current read and those being fetched.
+         */
+        void evict();
+
+        ConnectionPool& pool;
+        size_t memoryCap;
+
+        FlatMap<mcpp::Coordinate2D, int, CoordHash> tileIndex{};
+        std::vector<std::unique_ptr<Tile>> tiles{};
+        std::vector<int> freeSlots{};
+
+        int newest = -1;
+        int oldest = -1;
+
+        // incremented per read; tiles with lastUse == clock are in use
+        uint64_t clock = 0;
+
+        // writes a fetch may have missed, and where each fetch out starts
+        std::vector<LoggedWrite> writeLog{};
+        std::vector<uint64_t> fetchesSince{};
+        uint64_t nextWrite = 0;
+
+        Stats stats{};
+        mutable std::mutex lock;
+        std::condition_variable fetchDone;
+
+        // orders the writes sent to the pool; never held with the lock
+        std::mutex writeLock;
+        std::condition_variable writeTurn;
+        uint64_t nextForward = 0;
+};
+
+#endif
@@ -0,0 +1,286 @@
+#include "WorldSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// blocks are read straight out of the mapping
+static_assert(std::is_trivially_copyable<mcpp::BlockType>::value &&
+              sizeof(mcpp::BlockType) == 2 * sizeof(int32_t),
+              "mcpp::BlockType must be two plain ints to be mapped");
+
+
+uint64_t WorldSnapshot::align(uint64_t offset) {
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+
+void WorldSnapshot::save(const std::string& path, std::vector<TileView> tiles) {
+
+    std::sort(tiles.begin(), tiles.end(),
+        [](const TileView& a, const TileView& b) {
+            return a.key.x < b.key.x || (a.key.x == b.key.x && a.key.z < b.key.z);
+        });
+
+    const size_t COLUMNS = size_t(TILE_SIZE) * TILE_SIZE;
+
+    // lay the arrays out first, so the index can be written before them
+    std::vector<TileEntry> index(tiles.size());
+    uint64_t offset = align(sizeof(Header) + tiles.size() * sizeof(TileEntry));
+
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const TileView& tile = tiles[i];
+        TileEntry& entry = index[i];
+
+        entry = TileEntry{tile.key.x, tile.key.z, 0, -1, 0, 0};
+
+        if (tile.heights != nullptr) {
+            entry.heightsOffset = offset;
+            offset = align(offset + COLUMNS * sizeof(int32_t));
+        }
+        if (tile.blocks != nullptr && tile.yMax >= tile.yMin) {
+            entry.yMin = tile.yMin;
+            entry.yMax = tile.yMax;
+            entry.blocksOffset = offset;
+            offset = align(offset + size_t(tile.yMax - tile.yMin + 1) * COLUMNS *
+                                    sizeof(mcpp::BlockType));
+        }
+    }
+
+    Header header{};
+    std::memcpy(header.magic, "PFWS", 4);
+    header.version = VERSION;
+    header.tileSize = TILE_SIZE;
+    header.tileCount = uint32_t(tiles.size());
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.indexOffset = sizeof(Header);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    uint64_t written = 0;
+
+    auto put = [&out, &written](const void* bytes, uint64_t count) {
+        out.write(static_cast<const char*>(bytes), std::streamsize(count));
+        written += count;
+    };
+    auto padTo = [&put, &written](uint64_t target) {
+        const char zeros[ALIGNMENT] = {};
+        put(zeros, target - written);
+    };
+
+    put(&header, sizeof(header));
+    put(index.data(), index.size() * sizeof(TileEntry));
+
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (index[i].heightsOffset != 0) {
+            padTo(index[i].heightsOffset);
+            put(tiles[i].heights, COLUMNS * sizeof(int32_t));
+        }
+        if (index[i].blocksOffset != 0) {
+            padTo(index[i].blocksOffset);
+            put(tiles[i].blocks, size_t(index[i].yMax - index[i].yMin + 1) *
+                                 COLUMNS * sizeof(mcpp::BlockType));
+        }
+    }
+    padTo(offset);
+
+    if (!out) {
+        throw std::runtime_error("Failed to write world snapshot");
+    }
+
+    return;
+}
+
+
+WorldSnapshot::WorldSnapshot(const std::string& path) {
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Cannot open world snapshot");
+    }
+
+    struct stat info{};
+    bool isMapped = false;
+
+    if (fstat(fd, &info) == 0 && size_t(info.st_size) >= sizeof(Header)) {
+        void* mapping = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const unsigned char*>(mapping);
+            size = size_t(info.st_size);
+            isMapped = true;
+        }
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+
+    if (!isMapped) {
+        throw std::runtime_error("Cannot map world snapshot");
+    }
+
+    const Header& header = *reinterpret_cast<const Header*>(data);
+
+    const size_t COLUMNS = size_t(TILE_SIZE) * TILE_SIZE;
+    bool isValid = std::memcmp(header.magic, "PFWS", 4) == 0 &&
+                   header.version == VERSION &&
+                   header.tileSize == uint32_t(TILE_SIZE) &&
+                   header.byteOrder == BYTE_ORDER_MARK &&
+                   header.indexOffset % alignof(TileEntry) == 0 &&
+                   header.indexOffset <= size &&
+                   header.tileCount <= (size - header.indexOffset) / sizeof(TileEntry);
+
+    if (isValid) {
+        entries = reinterpret_cast<const TileEntry*>(data + header.indexOffset);
+        tileCount = header.tileCount;
+    }
+
+    // only the index is checked; the arrays it points at are read as they are
+    for (size_t i = 0; isValid && i < tileCount; ++i) {
+        const TileEntry& entry = entries[i];
+
+        bool isSorted = i == 0 || entries[i - 1].x < entry.x ||
+                        (entries[i - 1].x == entry.x && entries[i - 1].z < entry.z);
+
+        bool heightsFit = entry.heightsOffset == 0 ||
+            (entry.heightsOffset % ALIGNMENT == 0 &&
+             entry.heightsOffset <= size &&
+             COLUMNS * sizeof(int32_t) <= size - entry.heightsOffset);
+
+        bool blocksFit = entry.blocksOffset == 0 ||
+            (entry.blocksOffset % ALIGNMENT == 0 &&
+             entry.yMax >= entry.yMin &&
+             entry.blocksOffset <= size &&
+             uint64_t(int64_t(entry.yMax) - entry.yMin + 1) <=
+                 (size - entry.blocksOffset) / (COLUMNS * sizeof(mcpp::BlockType)));
+
+        isValid = isSorted && heightsFit && blocksFit;
+    }
+
+    if (!isValid) {
+        munmap(const_cast<unsigned char*>(data), size);
+        throw std::runtime_error("Not a valid world snapshot");
+    }
+}
+
+
+WorldSnapshot::~WorldSnapshot() {
+    munmap(const_cast<unsigned char*>(data), size);
+}
+
+
+size_t WorldSnapshot::getTileCount() const {
+    return tileCount;
+}
+
+
+WorldSnapshot::TileView WorldSnapshot::tileAt(size_t i) const {
+    return viewOf(entries[i]);
+}
+
+
+size_t WorldSnapshot::getBytes() const {
+    return size;
+}
+
+
+const WorldSnapshot::TileEntry* WorldSnapshot::findEntry(int tileX, int tileZ) const {
+
+    const TileEntry* end = entries + tileCount;
+    const TileEntry* found = std::lower_bound(entries, end, mcpp::Coordinate2D(tileX, tileZ),
+        [](const TileEntry& entry, const mcpp::Coordinate2D& key) {
+            return entry.x < key.x || (entry.x == key.x && entry.z < key.z);
+        });
+
+    bool isFound = found != end && found->x == tileX && found->z == tileZ;
+
+    return isFound ? found : nullptr;
+}
+
+
+WorldSnapshot::TileView WorldSnapshot::viewOf(const TileEntry& entry) const {
+
+    TileView view{mcpp::Coordinate2D(entry.x, entry.z), nullptr, nullptr,
+                  entry.yMin, entry.yMax};
+
+    if (entry.heightsOffset != 0) {
+        view.heights = reinterpret_cast<const int32_t*>(data + entry.heightsOffset);
+    }
+    if (entry.blocksOffset != 0) {
+        view.blocks = reinterpret_cast<const mcpp::BlockType*>(data + entry.blocksOffset);
+    }
+
+    return view;
+}
+
+
+mcpp::HeightMap WorldSnapshot::getHeights(const mcpp::Coordinate& loc1,
+                                          const mcpp::Coordinate& loc2) const {
+
+    mcpp::Coordinate lo(std::min(loc1.x, loc2.x), 0, std::min(loc1.z, loc2.z));
+    mcpp::Coordinate hi(std::max(loc1.x, loc2.x), 0, std::max(loc1.z, loc2.z));
+
+    int xLen = hi.x - lo.x + 1;
+    int zLen = hi.z - lo.z + 1;
+    std::vector<int> heights(size_t(xLen) * zLen);
+
+    // same layout as mcpp: index = x * zLen + z
+    for (int x = 0; x < xLen; ++x) {
+        for (int z = 0; z < zLen; ++z) {
+            int worldX = lo.x + x;
+            int worldZ = lo.z + z;
+            const TileEntry* entry = findEntry(worldX >> TILE_SHIFT, worldZ >> TILE_SHIFT);
+
+            if (entry == nullptr || entry->heightsOffset == 0) {
+                throw std::out_of_range("Column not in world snapshot");
+            }
+
+            heights[size_t(x) * zLen + z] = viewOf(*entry).heights[
+                (worldX & (TILE_SIZE - 1)) * TILE_SIZE + (worldZ & (TILE_SIZE - 1))];
+        }
+    }
+
+    return mcpp::HeightMap(lo, hi, heights);
+}
+
+
+SurfaceSlab WorldSnapshot::getSurface(const mcpp::HeightMap& heights,
+                                      int below, int above) const {
+
+    SurfaceSlab slab(heights, below, above);
+
+    mcpp::Coordinate2D base = slab.base_pt();
+    int xLen = slab.x_len();
+    int zLen = slab.z_len();
+
+    for (int x = 0; x < xLen; ++x) {
+        for (int z = 0; z < zLen; ++z) {
+            mcpp::Coordinate2D column(base.x + x, base.z + z);
+            const TileEntry* entry = findEntry(column.x >> TILE_SHIFT, column.z >> TILE_SHIFT);
+
+            int bottom = slab.bottomAt(column);
+            int top = slab.topAt(column);
+
+            if (entry == nullptr || entry->blocksOffset == 0 ||
+                    bottom < entry->yMin || top > entry->yMax) {
+                throw std::out_of_range("Surface not in world snapshot");
+            }
+
+            const mcpp::BlockType* blocks = viewOf(*entry).blocks +
+                (column.x & (TILE_SIZE - 1)) * TILE_SIZE + (column.z & (TILE_SIZE - 1));
+
+            for (int y = bottom; y <= top; ++y) {
+                slab.set(mcpp::Coordinate(column.x, y, column.z),
+                         blocks[size_t(y - entry->yMin) * TILE_SIZE * TILE_SIZE]);
+            }
+        }
+    }
+
+    return slab;
+}
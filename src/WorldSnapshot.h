@@ -0,0 +1,165 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mcpp/mcpp.h>
+
+#include "SurfaceSlab.h"
+
+/**
+ * @brief Saved heights and blocks of a region, read in place through mmap.
+ *
+ * The file holds 16x16 column tiles laid out like the WorldModel's, so a
+ * snapshot is opened by mapping it and checking its header and tile index;
+ * the terrain itself is never parsed or copied until it is read.
+ *
+ * Layout, in host byte order (the header records it, and a file from a
+ * host of the other order is rejected):
+ * - Header, 64 bytes: magic "PFWS", version, tile size, tile count,
+ *   byte order mark, then the offset of the tile index.
+ * - Tile index: one TileEntry per tile, sorted by (x, z) tile coordinate.
+ * - Tile data: every array starts on a 64-byte boundary. Heights are 256
+ *   int32 indexed x * 16 + z; blocks are (yMax - yMin + 1) layers of 256
+ *   mcpp::BlockType indexed (y - yMin) * 256 + x * 16 + z.
+ *
+ * Read only and thread safe.
+ */
+class WorldSnapshot {
+    public:
+        static constexpr int TILE_SHIFT = 4;
+        static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+        static constexpr uint32_t VERSION = 1;
+
+        /**
+         * @brief The data of one tile, borrowed from its owner.
+         */
+        struct TileView {
+            mcpp::Coordinate2D key;
+
+            // null if the tile has no heights
+            const int32_t* heights;
+
+            // null if the tile has no blocks, else layers [yMin, yMax]
+            const mcpp::BlockType* blocks;
+            int yMin;
+            int yMax;
+        };
+
+        /**
+         * @brief Writes tiles to a snapshot file.
+         * @param path File to create or replace.
+         * @param tiles Tiles to save, in any order; keys must be distinct.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        static void save(const std::string& path, std::vector<TileView> tiles);
+
+        /**
+         * @brief Maps a snapshot file and checks its header and tile index.
+         * @param path File written by save().
+         * @throws std::runtime_error If the file cannot be mapped or is not a
+         *   valid snapshot for this host.
+         */
+        explicit WorldSnapshot(const std::string& path);
+
+        ~WorldSnapshot();
+
+        WorldSnapshot(const WorldSnapshot&) = delete;
+        WorldSnapshot& operator=(const WorldSnapshot&) = delete;
+
+        /**
+         * @brief Returns the number of tiles saved.
+         * @return Tile count.
+         */
+        size_t getTileCount() const;
+
+        /**
+         * @brief Returns the tile at position @p i of the sorted index.
+         * @param i Index below getTileCount().
+         * @return View into the mapping, valid while the snapshot lives.
+         */
+        TileView tileAt(size_t i) const;
+
+        /**
+         * @brief Assembles the heights of a region from the mapped tiles.
+         * @param loc1 One corner (y ignored).
+         * @param loc2 Opposite corner (y ignored).
+         * @return Height map in mcpp's layout.
+         * @throws std::out_of_range If a column has no saved height.
+         */
+        mcpp::HeightMap getHeights(const mcpp::Coordinate& loc1,
+                                   const mcpp::Coordinate& loc2) const;
+
+        /**
+         * @brief Assembles the blocks around the surface of a region.
+         * @param heights Surface heights of the region (e.g. from getHeights).
+         * @param below Blocks kept below the surface.
+         * @param above Blocks kept above the surface.
+         * @return Slab of the region.
+         * @throws std::out_of_range If a column's slab is not fully saved.
+         */
+        SurfaceSlab getSurface(const mcpp::HeightMap& heights,
+                               int below = SurfaceSlab::DEFAULT_BELOW,
+                               int above = SurfaceSlab::DEFAULT_ABOVE) const;
+
+        /**
+         * @brief Returns the size of the mapped file.
+         * @return Byte count.
+         */
+        size_t getBytes() const;
+
+    private:
+        static constexpr size_t ALIGNMENT = 64;
+        static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        /**
+         * @brief Fixed-size start of the file.
+         */
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint32_t tileSize;
+            uint32_t tileCount;
+            uint32_t byteOrder;
+            uint32_t reserved;
+            uint64_t indexOffset;
+            unsigned char padding[32];
+        };
+
+        /**
+         * @brief Index entry of one tile; offsets are 0 for missing arrays.
+         */
+        struct TileEntry {
+            int32_t x;
+            int32_t z;
+            int32_t yMin;
+            int32_t yMax;
+            uint64_t heightsOffset;
+            uint64_t blocksOffset;
+        };
+
+        /**
+         * @brief Rounds @p offset up to the next ALIGNMENT boundary.
+         */
+        static uint64_t align(uint64_t offset);
+
+        /**
+         * @brief Finds a tile by tile coordinate with a binary search.
+         * @return The entry, or nullptr if the tile is not saved.
+         */
+        const TileEntry* findEntry(int tileX, int tileZ) const;
+
+        /**
+         * @brief Returns the view of an index entry.
+         */
+        TileView viewOf(const TileEntry& entry) const;
+
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        const TileEntry* entries = nullptr;
+        size_t tileCount = 0;
+};
+
+#endif
@@ -1,17 +1,23 @@
 #include "build_path.h"
+#include "Trace.h"
 #include <iostream>
 
 
 
-void buildPath(const Vector<mcpp::Coordinate2D>& plan,
-               const mcpp::HeightMap& heightMap,
-               const mcpp::Chunk& chunk) {
+BlockWriteBuffer::Stats buildPath(ConstSpan<mcpp::Coordinate2D> plan,
+                                  const mcpp::HeightMap& heightMap,
+                                  const SurfaceSlab& surface,
+                                  WorldBackend& world,
+                                  bool skipUnchanged) {
+
+    TRACE_SCOPE("buildPath");
 
     const int ALLOWED_Y_DIFF = 1;
-    mcpp::MinecraftConnection mc{};
+    BlockWriteBuffer writes{};
     mcpp::BlockType gravelBlock = mcpp::Blocks::GRAVEL;
     
-    Vector<mcpp::Coordinate> coords = toHeighestCoords(plan, heightMap);
+    SmallVector<mcpp::Coordinate, ROUTE_INLINE_CAP> coords =
+        toHeighestCoords(plan, heightMap);
 
     // We won't build on the first or last coords
     for (size_t i = 1; i < plan.getSize() - 1; ++i) {
@@ -23,9 +29,9 @@ void buildPath(const Vector<mcpp::Coordinate2D>& plan,
             int newY = prev.y + 1;
             mcpp::Coordinate newCoord(curr.x, newY, curr.z);
 
-            cutDown(curr, newCoord, mc);
+            cutDown(curr, newCoord, writes);
 
-            mc.setBlock(newCoord, gravelBlock);
+            writes.setBlock(newCoord, gravelBlock);
 
             coords[i] = newCoord;
         }
@@ -35,42 +41,46 @@ void buildPath(const Vector<mcpp::Coordinate2D>& plan,
             int newY = prev.y - 1;
             mcpp::Coordinate newCoord(curr.x, newY, curr.z);
 
-            buildUp(curr, newCoord, mc);
-            mc.setBlock(newCoord, gravelBlock);
+            buildUp(curr, newCoord, writes);
+            writes.setBlock(newCoord, gravelBlock);
 
             coords[i] = newCoord;
         }
 
         else {
             try {
-                mcpp::BlockType currBlock = chunk.get_worldspace(curr);
+                mcpp::BlockType currBlock = surface.get_worldspace(curr);
 
                 if (currBlock == mcpp::Blocks::STILL_WATER ||
                         currBlock == mcpp::Blocks::FLOWING_WATER) {
-                    supportGravel(curr, mc);
+                    supportGravel(curr, writes);
                 }
 
             } catch(std::out_of_range& excpt) {
-                supportGravel(curr, mc); 
+                supportGravel(curr, writes); 
             }
 
-            mc.setBlock(curr, gravelBlock);
+            writes.setBlock(curr, gravelBlock);
         }
 
     }
 
+    if (skipUnchanged) {
+        writes.dropUnchanged(surface);
+    }
 
+    writes.flush(world);
 
-    return;
+    return writes.getStats();
 }
 
 
 
-Vector<mcpp::Coordinate> 
-toHeighestCoords(const Vector<mcpp::Coordinate2D>& vec,
+SmallVector<mcpp::Coordinate, ROUTE_INLINE_CAP> 
+toHeighestCoords(ConstSpan<mcpp::Coordinate2D> vec,
                  const mcpp::HeightMap& heightMap) {
 
-    Vector<mcpp::Coordinate> highestCoords{};
+    SmallVector<mcpp::Coordinate, ROUTE_INLINE_CAP> highestCoords{};
 
     try {
 
@@ -82,7 +92,7 @@ toHeighestCoords(const Vector<mcpp::Coordinate2D>& vec,
         }
 
     } catch(std::out_of_range& excpt) {
-        highestCoords = Vector<mcpp::Coordinate>();
+        highestCoords.clear();
     }
 
     return highestCoords;
@@ -92,7 +102,7 @@ toHeighestCoords(const Vector<mcpp::Coordinate2D>& vec,
 
 void cutDown(const mcpp::Coordinate& prevCoord, 
              const mcpp::Coordinate& newCoord,
-             mcpp::MinecraftConnection& mc) {
+             BlockWriteBuffer& writes) {
 
     if (prevCoord.y > newCoord.y) {
 
@@ -100,7 +110,7 @@ void cutDown(const mcpp::Coordinate& prevCoord,
         mcpp::Coordinate initCoord(newCoord);
         ++initCoord.y;
         
-        mc.setBlocks(initCoord, prevCoord, airBlock);
+        writes.setBlocks(initCoord, prevCoord, airBlock);
         
     }
     
@@ -111,7 +121,7 @@ void cutDown(const mcpp::Coordinate& prevCoord,
 
 void buildUp(const mcpp::Coordinate& prevCoord, 
              const mcpp::Coordinate& newCoord,
-             mcpp::MinecraftConnection& mc) {
+             BlockWriteBuffer& writes) {
 
     if (prevCoord.y < newCoord.y) {
 
@@ -119,7 +129,7 @@ void buildUp(const mcpp::Coordinate& prevCoord,
         mcpp::Coordinate initCoord(newCoord);
         --initCoord.y;
         
-        mc.setBlocks(initCoord, prevCoord, grassBlock);
+        writes.setBlocks(initCoord, prevCoord, grassBlock);
     }
 
     return;
@@ -127,12 +137,12 @@ void buildUp(const mcpp::Coordinate& prevCoord,
 
 
 void supportGravel(const mcpp::Coordinate& currCoord,
-                   mcpp::MinecraftConnection& mc) {
+                   BlockWriteBuffer& writes) {
     
     mcpp::Coordinate coord(currCoord);
     
     coord.y--;
-    mc.setBlock(coord, mcpp::Blocks::DIRT);
+    writes.setBlock(coord, mcpp::Blocks::DIRT);
     
     return;
 }
@@ -1,7 +1,12 @@
 #ifndef BUILD_PATH_H
 #define BUILD_PATH_H
 
-#include "Vector.h"
+#include "SmallVector.h"
+#include "routes.h"
+#include "BlockWriteBuffer.h"
+#include "WorldBackend.h"
+#include "SurfaceSlab.h"
+#include "Span.h"
 #include <mcpp/mcpp.h>
 
 /**
@@ -9,15 +14,23 @@
  *
  * Projects points to their highest Y using the height map, then adjusts
  * terrain by carving or filling as needed. Handles small elevation
- * changes and water, ensuring a continuous gravel path.
+ * changes and water, ensuring a continuous gravel path. Edits are
+ * collected in a BlockWriteBuffer and sent in one coalesced flush.
  *
  * @param plan Ordered 2D coordinates from start -> end.
  * @param heightMap Height data used to find top Y at each (x,z).
- * @param chunk Block data used to detect water and air.
+ * @param surface Blocks around the surface, used to detect water and air.
+ * @param world Backend the edits are flushed to.
+ * @param skipUnchanged True to drop edits that @p surface shows are already
+ *   in place; only valid if @p surface is current. Edits outside the slab
+ *   are always issued.
+ * @return Blocks issued and skipped, and the number of write calls.
  */
-void buildPath(const Vector<mcpp::Coordinate2D>& plan,
-               const mcpp::HeightMap& heightMap,
-               const mcpp::Chunk& chunk);
+BlockWriteBuffer::Stats buildPath(ConstSpan<mcpp::Coordinate2D> plan,
+                                  const mcpp::HeightMap& heightMap,
+                                  const SurfaceSlab& surface,
+                                  WorldBackend& world,
+                                  bool skipUnchanged = true);
 
 /* ------------------------------------------
  * ------------ Helper functions ------------
@@ -31,10 +44,10 @@ void buildPath(const Vector<mcpp::Coordinate2D>& plan,
  *
  * @param vec Input 2D path coordinates.
  * @param heightMap World height data for (x,z) -> y lookup.
- * @return 3D coordinates positioned on terrain surface.
+ * @return 3D coordinates positioned on terrain surface (inline for short routes).
  */
-Vector<mcpp::Coordinate>
-toHeighestCoords(const Vector<mcpp::Coordinate2D>& vec,
+SmallVector<mcpp::Coordinate, ROUTE_INLINE_CAP>
+toHeighestCoords(ConstSpan<mcpp::Coordinate2D> vec,
                  const mcpp::HeightMap& heightMap);
 
 /**
@@ -45,11 +58,11 @@ toHeighestCoords(const Vector<mcpp::Coordinate2D>& vec,
  *
  * @param prevCoord Higher coordinate.
  * @param newCoord Lower coordinate (target of cut).
- * @param mc the minecraft connection.
+ * @param writes Buffer receiving the block edits.
  */
 void cutDown(const mcpp::Coordinate& prevCoord,
              const mcpp::Coordinate& newCoord,
-             mcpp::MinecraftConnection& mc);
+             BlockWriteBuffer& writes);
 
 /**
  * @brief Fill upward from @p prevCoord to @p newCoord.
@@ -58,11 +71,11 @@ void cutDown(const mcpp::Coordinate& prevCoord,
  *
  * @param prevCoord Lower coordinate.
  * @param newCoord Higher coordinate (target of fill).
- * @param mc the minecraft connection.
+ * @param writes Buffer receiving the block edits.
  */
 void buildUp(const mcpp::Coordinate& prevCoord,
              const mcpp::Coordinate& newCoord,
-             mcpp::MinecraftConnection& mc);
+             BlockWriteBuffer& writes);
 
 /**
  * @brief Place support below gravel at @p currCoord.
@@ -71,9 +84,9 @@ void buildUp(const mcpp::Coordinate& prevCoord,
  * air or water.
  *
  * @param currCoord Coordinate requiring gravel support.
- * @param mc the minecraft connection.
+ * @param writes Buffer receiving the block edits.
  */
 void supportGravel(const mcpp::Coordinate& currCoord,
-                   mcpp::MinecraftConnection& mc);
+                   BlockWriteBuffer& writes);
 
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "connect_points.h"
 #include "Map.h"
 #include <climits>
+#include <thread>
 
 
 
@@ -8,85 +9,691 @@
 std::vector<mcpp::Coordinate> 
 connectPoints(std::vector<mcpp::Coordinate>& connected,
               std::vector<mcpp::Coordinate>& unconnected,
-              const std::vector<Plot>& stdPlots,
+              const std::vector<Plot>& plots,
               const Plot& border,
               bool houseToWaypoint,
-              bool isTest) {
+              bool isTest,
+              const ConnectOptions& options) {
+
+    ConnectionPool pool{};
+
+    return connectPoints(connected, unconnected, plots, border, pool,
+                         houseToWaypoint, isTest, options);
+}
+
+
+
+std::vector<mcpp::Coordinate> 
+connectPoints(std::vector<mcpp::Coordinate>& connected,
+              std::vector<mcpp::Coordinate>& unconnected,
+              const std::vector<Plot>& plots,
+              const Plot& border,
+              ConnectionPool& pool,
+              bool houseToWaypoint,
+              bool isTest,
+              const ConnectOptions& options) {
+
+    // a margin below 1 would never widen, so the window could not grow
+    if (options.adaptiveWindow &&
+        (options.minMargin < 1 || options.maxMargin < options.minMargin)) {
+        throw std::runtime_error("Invalid adaptive window margins");
+    }
 
     std::vector<mcpp::Coordinate> isolated{};
 
     if (!connected.empty()) {
 
-        Vector<Plot> plots = stdPlots;
-    
-        const int SIDE_INCREASE = 20;
-        mcpp::MinecraftConnection mc;
+        auto runStart = std::chrono::steady_clock::now();
+        ConnectReport runReport{};
 
-        Map<mcpp::Coordinate2D, bool> occupied{};
-        
-        while (!unconnected.empty()) {
-            auto link = closestLink(connected, unconnected);
-    
-            Path path{};
+        std::optional<AllocStats> runAllocs{};
+        if (options.countAllocations) {
+            runAllocs.emplace();
+        }
+
+        if (options.traceOut != nullptr) {
+            Trace::clear();
+            Trace::setEnabled(true);
+            TRACE_THREAD("connectPoints", -1);
+        }
+
+        OccupancyGrid occupied{};
+        // every cell of the roads so far, which registerPath partly leaves free
+        OccupancyGrid planned{};
+        WorldModel world(pool, options.cacheBytes);
+
+        size_t tilesLoaded = 0;
+        if (options.snapshot != nullptr) {
+            tilesLoaded = world.load(*options.snapshot);
+        }
+
+        if (options.prefetch) {
+            auto fetchStart = std::chrono::steady_clock::now();
+            prefetchBorder(world, border, connected, unconnected,
+                           prefetchMargin(connected, unconnected, options),
+                           options.surfaceSlab);
+            runReport.fetchSeconds += secondsSince(fetchStart);
+        }
+
+        BoundedQueue<BuildJob> jobs(options.queueDepth);
+        std::exception_ptr planFailure = nullptr;
+        std::exception_ptr buildFailure = nullptr;
+        std::thread builder{};
+        BlockWriteBuffer::Stats& written = runReport.written;
+
+        auto selectStart = std::chrono::steady_clock::now();
+        LinkSelector links(connected, unconnected);
+        runReport.selectSeconds += secondsSince(selectStart);
+
+        std::optional<PlanWriter> planFile{};
+        if (options.planOut != nullptr) {
+            planFile.emplace(*options.planOut);
+        }
+
+        if (options.pipelined) {
+            builder = std::thread(runBuilder, std::ref(jobs), std::ref(world),
+                                  std::ref(written), std::ref(runReport.buildSeconds),
+                                  std::ref(buildFailure));
+        }
+
+        // the builder must be joined even if planning throws
+        try {
+            bool builderAlive = true;
+
+            if (options.globalPlan) {
+                mcpp::Coordinate first(std::min(border.origin.x, border.bound.x), 0,
+                                       std::min(border.origin.z, border.bound.z));
+                mcpp::Coordinate second(std::max(border.origin.x, border.bound.x), 0,
+                                        std::max(border.origin.z, border.bound.z));
+
+                auto fetchStart = std::chrono::steady_clock::now();
+                mcpp::HeightMap borderHeights = world.getHeights(first, second);
+                SurfaceSlab borderSurface = world.getSurface(borderHeights);
+                runReport.fetchSeconds += secondsSince(fetchStart);
+
+                auto searchStart = std::chrono::steady_clock::now();
+                std::vector<NetworkLink> network = planNetwork(connected, unconnected,
+                    plots, border, borderHeights, borderSurface,
+                    occupied, houseToWaypoint);
+                runReport.searchSeconds += secondsSince(searchStart);
+
+                for (size_t i = 0; i < network.size() && builderAlive; ++i) {
+                    TRACE_SCOPE_ARG("link", i);
+                    const NetworkLink& link = network[i];
+
+                    // terrain of just this road, current with the roads built so far
+                    fetchStart = std::chrono::steady_clock::now();
+                    BuildJob job = fetchPlanTerrain(world, link.plan);
+                    runReport.fetchSeconds += secondsSince(fetchStart);
+
+                    if (!houseToWaypoint) {
+                        connected.push_back(link.path.start);
+                        selectStart = std::chrono::steady_clock::now();
+                        links.addConnected(link.path.start);
+                        runReport.selectSeconds += secondsSince(selectStart);
+                    }
+
+                    if (planFile.has_value()) {
+                        planFile->write(link.path, link.cost, planFingerprint(link.plan,
+                            job.heightMap, job.surface, planned), link.plan);
+                        planned.setAll(link.plan);
+                    }
+
+                    registerPath(link.plan, occupied);
+                    ++runReport.links;
+
+                    if (options.pipelined) {
+                        builderAlive = jobs.push(BuildJob(job));
+                    }
+                    else {
+                        auto buildStart = std::chrono::steady_clock::now();
+                        addWriteStats(written,
+                            buildPath(link.plan, job.heightMap, job.surface, world));
+                        runReport.buildSeconds += secondsSince(buildStart);
+                    }
+
+                    if (isTest) {
+                        printRoute(link.plan, link.path);
+                    }
+
+                    selectStart = std::chrono::steady_clock::now();
+                    links.removeUnconnected(link.path.start);
+                    runReport.selectSeconds += secondsSince(selectStart);
+                }
+
+                if (isTest) {
+                    int totalCost = 0;
+                    for (const NetworkLink& link : network) {
+                        totalCost += link.cost;
+                    }
+                    std::cout << "Network plan: " << network.size()
+                              << " links, cost " << totalCost << std::endl;
+                }
+            }
+
+            while (!links.isEmpty() && builderAlive) {
+                TRACE_SCOPE_ARG("link", runReport.links + isolated.size());
+                selectStart = std::chrono::steady_clock::now();
+                auto link = links.next();
+                runReport.selectSeconds += secondsSince(selectStart);
     
-            //We begin from unconnected to the connected (House -> Waypoint)
-            path.start = link.first;
-            path.end = link.second;
+                Path path{};
     
-            mcpp::Coordinate firstCachePos(path.start);
-            mcpp::Coordinate secondCachePos(path.end);
+                //We begin from unconnected to the connected (House -> Waypoint)
+                path.start = link.first;
+                path.end = link.second;
     
-            int dist = getManhattanDist(firstCachePos, secondCachePos);
+                std::optional<AllocStats> linkAllocs{};
+                if (runAllocs.has_value()) {
+                    linkAllocs.emplace();
+                }
+
+                BuildJob job = planLink(world, path, plots, border, occupied,
+                                        options, runReport);
+
+                if (linkAllocs.has_value()) {
+                    runReport.linkPeakBytes = std::max(runReport.linkPeakBytes,
+                                                       linkAllocs->total().peakBytes);
+                    linkAllocs.reset();
+                }
+                const SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP>& plan = job.plan;
     
-            increaseMargin(firstCachePos, secondCachePos,
-                 std::max(SIDE_INCREASE, dist / SIDE_INCREASE));
+                if (plan.getSize() > 0) {
     
-            //Caches, for fast lookups
-            mcpp::HeightMap heightMap = 
-                 mc.getHeights(firstCachePos, secondCachePos);
-            mcpp::Chunk chunk = 
-                 mc.getBlocks(firstCachePos, secondCachePos);
-            
-            Vector<mcpp::Coordinate2D> plan = 
-                 findPath(path, plots, border, heightMap, chunk, occupied);
+                    if (!houseToWaypoint) {
+                        connected.push_back(path.start);
+                        selectStart = std::chrono::steady_clock::now();
+                        links.addConnected(path.start);
+                        runReport.selectSeconds += secondsSince(selectStart);
+                    }
     
-            if (plan.getSize() > 0) {
+                    if (planFile.has_value()) {
+                        planFile->write(path, job.cost, planFingerprint(plan,
+                            job.heightMap, job.surface, planned), plan);
+                        planned.setAll(plan);
+                    }
+
+                    registerPath(plan, occupied);
+
+                    if (options.pipelined) {
+                        builderAlive = jobs.push(BuildJob(job));
+                    }
+                    else {
+                        auto buildStart = std::chrono::steady_clock::now();
+                        addWriteStats(written,
+                            buildPath(plan, job.heightMap, job.surface, world));
+                        runReport.buildSeconds += secondsSince(buildStart);
+                    }
+
+                    ++runReport.links;
+                }
+                else {
+                    isolated.push_back(path.start);
+                }
     
-                if (!houseToWaypoint) {
-                    connected.push_back(path.start);
+                if (isTest) {
+                    printRoute(plan, path);
                 }
+            
+                //remove path.start, for both cases (found path or didn't find path)
+                selectStart = std::chrono::steady_clock::now();
+                links.removeUnconnected(path.start);
+                runReport.selectSeconds += secondsSince(selectStart);
     
-                buildPath(plan, heightMap, chunk);
-                registerPath(plan, occupied);
             }
-            else {
-                isolated.push_back(path.start);
+        } catch (...) {
+            planFailure = std::current_exception();
+        }
+
+        unconnected = links.remaining();
+
+        jobs.close();
+        if (builder.joinable()) {
+            builder.join();
+        }
+
+        if (options.traceOut != nullptr) {
+            Trace::setEnabled(false);
+        }
+
+        if (planFailure != nullptr) {
+            std::rethrow_exception(planFailure);
+        }
+        if (buildFailure != nullptr) {
+            std::rethrow_exception(buildFailure);
+        }
+
+        if (!options.snapshotOut.empty()) {
+            world.save(options.snapshotOut);
+        }
+
+        runReport.isolated = isolated.size();
+        runReport.cache = world.getStats();
+        runReport.totalSeconds = secondsSince(runStart);
+
+        if (runAllocs.has_value()) {
+            for (int k = 0; k < AllocStats::KIND_COUNT; ++k) {
+                runReport.allocations[k] = runAllocs->get(AllocStats::Kind(k));
             }
-    
+            runReport.allocationTotal = runAllocs->total();
+        }
+
+        size_t traceSpans = 0;
+        if (options.traceOut != nullptr) {
+            traceSpans = Trace::writeJson(*options.traceOut);
+        }
+
+        if (options.report != nullptr) {
+            *options.report = runReport;
+        }
+
+        if (isTest) {
+            if (options.snapshot != nullptr) {
+                std::cout << "Snapshot: " << tilesLoaded << " tiles loaded" << std::endl;
+            }
+            std::cout << "Blocks written: " << written.blocksIssued
+                      << " in " << written.calls << " calls, skipped "
+                      << written.blocksSkipped << " unchanged" << std::endl;
+            const WorldModel::Stats& cache = runReport.cache;
+            std::cout << "Terrain tiles: " << cache.hits << " hits, "
+                      << cache.misses << " misses, " << cache.fetches
+                      << " fetches, " << cache.bytesFetched << " bytes fetched, "
+                      << cache.evictions << " evictions" << std::endl;
+            const WindowStats& windows = runReport.windows;
+            std::cout << "Search windows: " << windows.searches << " searches, "
+                      << windows.growths << " grown, " << windows.rescued
+                      << " rescued, " << (windows.bytesFixed - windows.bytesRequested)
+                      << " bytes saved vs fixed margin" << std::endl;
+            if (planFile.has_value()) {
+                std::cout << "Plan file: " << planFile->getCount() << " roads in "
+                          << planFile->bytesWritten() << " bytes" << std::endl;
+            }
+            if (options.traceOut != nullptr) {
+                std::cout << "Trace: " << traceSpans << " spans, "
+                          << Trace::getDropped() << " dropped" << std::endl;
+            }
+            if (runAllocs.has_value()) {
+                std::cout << "Allocations:";
+                for (int k = 0; k < AllocStats::KIND_COUNT; ++k) {
+                    const AllocStats::Counters& kind = runReport.allocations[k];
+                    std::cout << " " << AllocStats::kindName(AllocStats::Kind(k))
+                              << " " << kind.allocations << " ("
+                              << kind.reallocations << " grown, " << kind.bytes
+                              << " bytes, peak " << kind.peakBytes << ")"
+                              << (k + 1 < AllocStats::KIND_COUNT ? "," : "");
+                }
+                std::cout << "; link peak " << runReport.linkPeakBytes
+                          << " bytes" << std::endl;
+            }
+            std::cout << "Phases: fetch " << runReport.fetchSeconds
+                      << " s, search " << runReport.searchSeconds
+                      << " s, build " << runReport.buildSeconds
+                      << " s, select " << runReport.selectSeconds
+                      << " s, total " << runReport.totalSeconds << " s" << std::endl;
+        }
+    }
+
+    return isolated;
+
+}
+
+
+
+
+
+std::vector<mcpp::Coordinate>
+replayPlans(std::istream& in,
+            ConnectionPool& pool,
+            bool isTest,
+            const ConnectOptions& options) {
+
+    std::vector<mcpp::Coordinate> skipped{};
+
+    PlanReader reader(in);
+    WorldModel world(pool, options.cacheBytes);
+    OccupancyGrid planned{};
+    BlockWriteBuffer::Stats written{};
+
+    PlanRecord record{};
+
+    while (reader.next(record)) {
+        BuildJob job = fetchPlanTerrain(world, record.plan);
+
+        uint64_t fingerprint = planFingerprint(record.plan, job.heightMap,
+                                               job.surface, planned);
+
+        if (fingerprint == record.fingerprint) {
+            addWriteStats(written,
+                buildPath(record.plan, job.heightMap, job.surface, world));
+        }
+        else {
+            skipped.push_back(record.path.start);
+
             if (isTest) {
-                printRoute(plan, path);
+                std::cout << "Terrain changed under: " << record.path.start
+                          << " -> " << record.path.end << std::endl;
             }
-            
-            //remove path.start, for both cases (found path or didn't find path)
-            unconnected.erase(std::remove(unconnected.begin(), 
-                 unconnected.end(), path.start), unconnected.end());
-    
         }
 
+        // later fingerprints leave out this road's cells, built or not
+        planned.setAll(record.plan);
     }
 
-    return isolated;
+    if (isTest) {
+        std::cout << "Replayed " << reader.getCount() << " roads from "
+                  << reader.bytesRead() << " bytes, skipped " << skipped.size()
+                  << std::endl;
+        std::cout << "Blocks written: " << written.blocksIssued
+                  << " in " << written.calls << " calls, skipped "
+                  << written.blocksSkipped << " unchanged" << std::endl;
+    }
+
+    return skipped;
+}
+
+
+
+
+
+BuildJob planLink(WorldModel& world,
+                  const Path& path,
+                  const std::vector<Plot>& plots,
+                  const Plot& border,
+                  const OccupancyGrid& occupied,
+                  const ConnectOptions& options,
+                  ConnectReport& runReport) {
+
+    WindowStats& windows = runReport.windows;
+
+    int dist = getManhattanDist(path.start, path.end);
+    int fixedMargin = std::max(SIDE_INCREASE, dist / SIDE_INCREASE);
+    int margin = options.adaptiveWindow
+        ? std::max({1, options.minMargin, dist / SIDE_INCREASE})
+        : fixedMargin;
+
+    mcpp::Coordinate first{};
+    mcpp::Coordinate second{};
+
+    searchWindow(path, fixedMargin, fixedMargin, first, second);
+    windows.bytesFixed += windowBytes(first, second);
+
+    searchWindow(path, margin, fixedMargin, first, second);
+
+    //Caches, for fast lookups
+    auto fetchStart = std::chrono::steady_clock::now();
+    BuildJob job = fetchWindow(world, first, second, options.surfaceSlab);
+    runReport.fetchSeconds += secondsSince(fetchStart);
+
+    auto searchStart = std::chrono::steady_clock::now();
+    SearchReport report{};
+    job.plan = findPath(path, plots, border, job.heightMap, job.surface,
+                        occupied, &report);
+    job.cost = report.cost;
+    runReport.searchSeconds += secondsSince(searchStart);
+
+    ++windows.searches;
+    windows.bytesRequested += windowBytes(first, second);
 
+    // only a search that was cut off by its window can gain from a wider one
+    while (job.plan.getSize() == 0 && report.hitEdge &&
+           options.adaptiveWindow && margin < options.maxMargin) {
+
+        margin = std::min(std::max(margin + 1, margin * WINDOW_GROWTH),
+                          options.maxMargin);
+        searchWindow(path, margin, fixedMargin, first, second);
+
+        fetchStart = std::chrono::steady_clock::now();
+        job = fetchWindow(world, first, second, options.surfaceSlab);
+        runReport.fetchSeconds += secondsSince(fetchStart);
+
+        searchStart = std::chrono::steady_clock::now();
+        report = SearchReport();
+        job.plan = findPath(path, plots, border, job.heightMap, job.surface,
+                            occupied, &report);
+        job.cost = report.cost;
+        runReport.searchSeconds += secondsSince(searchStart);
+
+        ++windows.searches;
+        ++windows.growths;
+        windows.bytesRequested += windowBytes(first, second);
+
+        if (job.plan.getSize() > 0) {
+            ++windows.rescued;
+        }
+    }
+
+    return job;
+}
+
+
+
+BuildJob fetchPlanTerrain(WorldModel& world,
+                          ConstSpan<mcpp::Coordinate2D> plan) {
+
+    mcpp::Coordinate lo(plan[0].x, 0, plan[0].z);
+    mcpp::Coordinate hi(plan[0].x, 0, plan[0].z);
+
+    for (const mcpp::Coordinate2D& coord : plan) {
+        lo.x = std::min(lo.x, coord.x);
+        lo.z = std::min(lo.z, coord.z);
+        hi.x = std::max(hi.x, coord.x);
+        hi.z = std::max(hi.z, coord.z);
+    }
+
+    mcpp::HeightMap heightMap = world.getHeights(lo, hi);
+    SurfaceSlab surface = world.getSurface(heightMap);
+
+    SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> route{};
+    for (const mcpp::Coordinate2D& coord : plan) {
+        route.push_back(coord);
+    }
+
+    return BuildJob{route, heightMap, surface};
+}
+
+
+
+uint64_t planFingerprint(ConstSpan<mcpp::Coordinate2D> plan,
+                         const mcpp::HeightMap& heightMap,
+                         const SurfaceSlab& surface,
+                         const OccupancyGrid& planned) {
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    uint64_t hash = FNV_OFFSET;
+
+    for (const mcpp::Coordinate2D& coord : plan) {
+        if (!planned.test(coord)) {
+            // a cell missing from the terrain hashes as an impossible height
+            int height = INT_MIN;
+            mcpp::BlockType top{};
+
+            try {
+                height = heightMap.get_worldspace(coord);
+                top = surface.get_worldspace(mcpp::Coordinate(coord.x, height, coord.z));
+            } catch (std::out_of_range& excpt) {
+                height = INT_MIN;
+            }
+
+            const int fields[] = {coord.x, coord.z, height, top.id, top.mod};
+            for (int field : fields) {
+                uint32_t value = static_cast<uint32_t>(field);
+
+                for (int i = 0; i < 4; ++i) {
+                    hash ^= (value >> (8 * i)) & 0xffu;
+                    hash *= FNV_PRIME;
+                }
+            }
+        }
+    }
+
+    return hash;
+}
+
+
+
+BuildJob fetchWindow(WorldModel& world,
+                     const mcpp::Coordinate& first,
+                     const mcpp::Coordinate& second,
+                     bool surfaceOnly) {
+
+    mcpp::HeightMap heightMap = world.getHeights(first, second);
+    SurfaceSlab surface = surfaceOnly
+        ? world.getSurface(heightMap)
+        : SurfaceSlab::fromChunk(world.getBlocks(first, second), heightMap);
+
+    return BuildJob{SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP>(),
+                    heightMap, surface};
 }
 
 
 
+void searchWindow(const Path& path,
+                  int margin,
+                  int yMargin,
+                  mcpp::Coordinate& first,
+                  mcpp::Coordinate& second) {
+
+    first = path.start;
+    second = path.end;
+
+    increaseMargin(first, second, margin);
+
+    // the y range does not follow the x/z margin
+    first.y = std::min(path.start.y, path.end.y) - yMargin;
+    second.y = std::max(path.start.y, path.end.y) + yMargin;
+
+    return;
+}
+
+
+
+long long windowBytes(const mcpp::Coordinate& first,
+                      const mcpp::Coordinate& second) {
+
+    long long columns = (long long)(std::abs(first.x - second.x) + 1) *
+                        (std::abs(first.z - second.z) + 1);
+    long long layers = std::abs(first.y - second.y) + 1;
+
+    return columns * (long long)(sizeof(int) + layers * sizeof(mcpp::BlockType));
+}
+
+
+
+void runBuilder(BoundedQueue<BuildJob>& jobs,
+                WorldBackend& world,
+                BlockWriteBuffer::Stats& written,
+                double& buildSeconds,
+                std::exception_ptr& failure) {
+
+    TRACE_THREAD("builder", -1);
+
+    try {
+        std::optional<BuildJob> job = jobs.pop();
+
+        while (job.has_value()) {
+            // the job's surface may predate earlier builds, so nothing is skipped
+            auto buildStart = std::chrono::steady_clock::now();
+            addWriteStats(written, buildPath(job->plan, job->heightMap,
+                                             job->surface, world, false));
+            buildSeconds += secondsSince(buildStart);
+            job = jobs.pop();
+        }
+
+    } catch (...) {
+        failure = std::current_exception();
+        jobs.close();
+    }
+
+    return;
+}
+
+
+
+void prefetchBorder(WorldModel& world,
+                    const Plot& border,
+                    const std::vector<mcpp::Coordinate>& connected,
+                    const std::vector<mcpp::Coordinate>& unconnected,
+                    int margin,
+                    bool surfaceOnly) {
+
+    TRACE_SCOPE("prefetchBorder");
+
+    int minY = INT_MAX;
+    int maxY = INT_MIN;
+
+    for (const mcpp::Coordinate& point : connected) {
+        minY = std::min(minY, point.y);
+        maxY = std::max(maxY, point.y);
+    }
+    for (const mcpp::Coordinate& point : unconnected) {
+        minY = std::min(minY, point.y);
+        maxY = std::max(maxY, point.y);
+    }
+
+    mcpp::Coordinate first(std::min(border.origin.x, border.bound.x) - margin,
+                           minY - margin,
+                           std::min(border.origin.z, border.bound.z) - margin);
+    mcpp::Coordinate second(std::max(border.origin.x, border.bound.x) + margin,
+                            maxY + margin,
+                            std::max(border.origin.z, border.bound.z) + margin);
+
+    if (surfaceOnly) {
+        // the slab itself is dropped; what matters is that its tiles are cached
+        world.getSurface(world.getHeights(first, second));
+    }
+    else {
+        world.prefetch(first, second);
+    }
+
+    return;
+}
+
+
+int prefetchMargin(const std::vector<mcpp::Coordinate>& connected,
+                   const std::vector<mcpp::Coordinate>& unconnected,
+                   const ConnectOptions& options) {
+
+    int longest = 0;
+
+    for (const mcpp::Coordinate& point : unconnected) {
+        int nearest = INT_MAX;
+        for (const mcpp::Coordinate& other : connected) {
+            nearest = std::min(nearest, getManhattanDist(point, other));
+        }
+        longest = std::max(longest, nearest);
+    }
+
+    // same margins as planLink's first search
+    int margin = std::max(SIDE_INCREASE, longest / SIDE_INCREASE);
+    if (options.adaptiveWindow) {
+        margin = std::max(margin, options.minMargin);
+    }
+
+    return margin;
+}
+
+
+
+void addWriteStats(BlockWriteBuffer::Stats& total,
+                   const BlockWriteBuffer::Stats& build) {
+
+    total.blocksIssued += build.blocksIssued;
+    total.blocksSkipped += build.blocksSkipped;
+    total.calls += build.calls;
+
+    return;
+}
+
 
 
 std::pair<mcpp::Coordinate, mcpp::Coordinate> 
 closestLink(std::vector<mcpp::Coordinate>& connected,
             std::vector<mcpp::Coordinate>& unconnected) {
 
+    TRACE_SCOPE("closestLink");
+
     std::pair<mcpp::Coordinate, mcpp::Coordinate> vertices{};
     int minDist = INT_MAX;
     
@@ -164,7 +771,7 @@ void increaseMargin(mcpp::Coordinate& first,
 }
 
 
-void printRoute(const Vector<mcpp::Coordinate2D>& plan, 
+void printRoute(ConstSpan<mcpp::Coordinate2D> plan, 
                 const Path& path) {
 
     if (plan.getSize() > 0) {
@@ -193,8 +800,8 @@ void printRoute(const Vector<mcpp::Coordinate2D>& plan,
 }
 
 
-void registerPath(const Vector<mcpp::Coordinate2D>& plan,
-                  Map<mcpp::Coordinate2D, bool>& occupiedCoords) { 
+void registerPath(ConstSpan<mcpp::Coordinate2D> plan,
+                  OccupancyGrid& occupiedCoords) { 
 
     const size_t FIRST_SKIP = 0;
     const size_t LAST_SKIP  = 12;
@@ -202,11 +809,16 @@ void registerPath(const Vector<mcpp::Coordinate2D>& plan,
     if (!(plan.getSize() <= FIRST_SKIP + LAST_SKIP)) {
 
         const size_t end = plan.getSize() - LAST_SKIP;
-        
-        for (size_t i = FIRST_SKIP; i < end; ++i) {
-            occupiedCoords[plan[i]] = true;
-        }
+
+        occupiedCoords.setAll(ConstSpan<mcpp::Coordinate2D>(
+            plan.begin() + FIRST_SKIP, end - FIRST_SKIP));
     }
 
     return;
-}
\ No newline at end of file
+}
+
+
+
+double secondsSince(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -3,6 +3,15 @@
 
 #include "build_path.h"
 #include "find_path.h"
+#include "ConnectionPool.h"
+#include "WorldModel.h"
+#include "BoundedQueue.h"
+#include "LinkSelector.h"
+#include "plan_network.h"
+#include "PlanWriter.h"
+#include "PlanReader.h"
+#include "Trace.h"
+#include "AllocStats.h"
 #include <mcpp/mcpp.h>
 
 #include <vector>
@@ -10,6 +19,198 @@
 #include <cmath>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <chrono>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+
+/**
+ * @brief Smallest margin, in blocks, fetched around a link; longer links
+ *   get dist / SIDE_INCREASE instead when that is larger.
+ */
+constexpr int SIDE_INCREASE = 20;
+
+/**
+ * @brief Factor an adaptive search window grows by after hitting its edge.
+ */
+constexpr int WINDOW_GROWTH = 2;
+
+struct ConnectReport;
+
+/**
+ * @brief Optional settings for connectPoints.
+ */
+struct ConnectOptions {
+    /**
+     * @brief Build each path on a worker thread while the next is planned.
+     *
+     * Occupancy is still updated as soon as a plan is committed, but a plan
+     * may read terrain fetched before earlier paths finished building. Paths
+     * only meet near their endpoints, where buildPath levels small
+     * differences anyway. For the same reason, unchanged blocks are not
+     * skipped in this mode.
+     */
+    bool pipelined = false;
+
+    /**
+     * @brief Planned paths that may wait for the builder before planning stalls.
+     */
+    size_t queueDepth = 2;
+
+    /**
+     * @brief Bytes of terrain the WorldModel may cache before evicting tiles.
+     */
+    size_t cacheBytes = WorldModel::DEFAULT_MEMORY_CAP;
+
+    /**
+     * @brief Download the terrain of the whole border area before planning.
+     *
+     * Replaces the per-link fetches with a few large ones; worth it when
+     * the links cover most of the village. The area is wide enough for the
+     * first search of every link; windows that an adaptive search widens
+     * beyond it are fetched on demand.
+     */
+    bool prefetch = false;
+
+    /**
+     * @brief Fetch only the blocks around the surface instead of whole cuboids.
+     *
+     * Path finding and building only read blocks a few cells from the
+     * terrain surface, so on hilly ground most of a padded cuboid is never
+     * looked at.
+     *
+     * Without it the cuboid is still fetched, but only its blocks within
+     * SurfaceSlab's default band are kept. Unchanged writes outside that
+     * band, such as deep fill under a steep step, are then issued rather
+     * than dropped, in either mode.
+     */
+    bool surfaceSlab = false;
+
+    /**
+     * @brief Plan all roads together from terrain costs before building any.
+     *
+     * Uses planNetwork over the border area instead of linking the nearest
+     * pair one at a time. Points the plan cannot reach are then linked the
+     * usual way.
+     */
+    bool globalPlan = false;
+
+    /**
+     * @brief Start each search in a tight corridor and widen it on demand.
+     *
+     * The x/z margin starts at max(minMargin, dist / SIDE_INCREASE). When a
+     * search fails after running into the edge of its window, the margin
+     * grows by WINDOW_GROWTH, up to maxMargin, and the search is run again
+     * on the wider terrain; the WorldModel only downloads the added tiles.
+     * The y range keeps the fixed margin. connectPoints throws
+     * std::runtime_error if minMargin is below 1 or maxMargin below minMargin.
+     */
+    bool adaptiveWindow = false;
+
+    /**
+     * @brief Initial x/z margin of an adaptive window.
+     */
+    int minMargin = 4;
+
+    /**
+     * @brief Largest x/z margin an adaptive window may grow to.
+     */
+    int maxMargin = 4 * SIDE_INCREASE;
+
+    /**
+     * @brief Stream receiving every committed road in the binary plan format.
+     *
+     * Roads are appended as they are committed; replayPlans() builds the
+     * file again later without any path finding. Must be opened in binary
+     * mode. Not written if null.
+     */
+    std::ostream* planOut = nullptr;
+
+    /**
+     * @brief Saved terrain to fill the cache with before planning.
+     *
+     * Regions the snapshot covers are planned without any download. It
+     * must still match the server: changes made since it was saved are
+     * not seen. Not used if null.
+     */
+    const WorldSnapshot* snapshot = nullptr;
+
+    /**
+     * @brief File to save the fetched terrain to once every road is built.
+     *
+     * The snapshot includes the roads just built, so it can seed the next
+     * run through @ref snapshot. Not saved if empty.
+     */
+    std::string snapshotOut;
+
+    /**
+     * @brief Receives a Chrome trace (JSON) of the run.
+     *
+     * Tracing is enabled for the duration of the run and the spans are
+     * written once every thread is done. Holds no spans unless the tree is
+     * built with PATHFIND_TRACE. Not written if null.
+     */
+    std::ostream* traceOut = nullptr;
+
+    /**
+     * @brief Count the container storage of the run with AllocStats.
+     *
+     * Counts the calling thread only (the planning side in pipelined mode)
+     * and also measures the peak of each link's search on its own.
+     */
+    bool countAllocations = false;
+
+    /**
+     * @brief Receives the phase times and counters of the run; not filled
+     *   if null.
+     */
+    ConnectReport* report = nullptr;
+};
+
+/**
+ * @brief Counters of the search windows used by connectPoints.
+ */
+struct WindowStats {
+    size_t searches = 0;
+    size_t growths = 0;
+    size_t rescued = 0;
+    long long bytesRequested = 0;
+    long long bytesFixed = 0;
+};
+
+/**
+ * @brief Where a connectPoints run spent its time, and what it sent.
+ *
+ * Phase times are wall-clock seconds summed over every call of the phase:
+ * fetch is terrain reads (prefetch included), search is findPath and
+ * planNetwork, build is buildPath with its writes, and select is the
+ * LinkSelector. In pipelined mode building overlaps the other phases, so
+ * the phases may add up to more than the total.
+ *
+ * The allocation counters are only filled with
+ * ConnectOptions::countAllocations.
+ */
+struct ConnectReport {
+    double totalSeconds = 0;
+    double fetchSeconds = 0;
+    double searchSeconds = 0;
+    double buildSeconds = 0;
+    double selectSeconds = 0;
+
+    size_t links = 0;
+    size_t isolated = 0;
+
+    WindowStats windows{};
+    BlockWriteBuffer::Stats written{};
+    WorldModel::Stats cache{};
+
+    AllocStats::Counters allocations[AllocStats::KIND_COUNT] = {};
+    AllocStats::Counters allocationTotal{};
+
+    // largest peak of container storage over a single link search
+    long long linkPeakBytes = 0;
+};
 
 /**
  * @brief Connect unconnected points to a growing set.
@@ -23,6 +224,34 @@
  * @param border Border of the village.
  * @param houseToWaypoint True for house→waypoint linking mode.
  * @param isTest True to print route debug info.
+ * @param options Optional settings (e.g. pipelined building).
+ * @return Returns a std::vector of isolated points
+ */
+std::vector<mcpp::Coordinate> 
+connectPoints(std::vector<mcpp::Coordinate>& connected,
+              std::vector<mcpp::Coordinate>& unconnected,
+              const std::vector<Plot>& plots,
+              const Plot& border,
+              bool houseToWaypoint,
+              bool isTest,
+              const ConnectOptions& options = ConnectOptions());
+
+/**
+ * @brief Connect unconnected points to a growing set, using shared connections.
+ *
+ * Same as above, but fetches terrain and writes paths through @p pool, so
+ * several calls can reuse the same connections. Terrain is read through a
+ * WorldModel that keeps what was fetched and applies our own writes, so
+ * each area is fetched about once per call rather than once per link.
+ *
+ * @param connected Points already linked (will grow).
+ * @param unconnected Points still unlinked (will shrink).
+ * @param plots Plot obstacles to avoid during pathfinding.
+ * @param border Border of the village.
+ * @param pool Connections used for region fetches and block writes.
+ * @param houseToWaypoint True for house→waypoint linking mode.
+ * @param isTest True to print route debug info.
+ * @param options Optional settings (e.g. pipelined building).
  * @return Returns a std::vector of isolated points
  */
 std::vector<mcpp::Coordinate> 
@@ -30,18 +259,201 @@ connectPoints(std::vector<mcpp::Coordinate>& connected,
               std::vector<mcpp::Coordinate>& unconnected,
               const std::vector<Plot>& plots,
               const Plot& border,
+              ConnectionPool& pool,
               bool houseToWaypoint,
-              bool isTest);
+              bool isTest,
+              const ConnectOptions& options = ConnectOptions());
+
+/**
+ * @brief Builds the roads of a plan file written by connectPoints.
+ *
+ * Roads are built in file order, each on terrain fetched around its own
+ * route, so no search is run. A road is skipped if the terrain under it
+ * no longer matches the fingerprint it was planned with.
+ *
+ * @param in Plan file, opened in binary mode; read as a stream.
+ * @param pool Connections used for terrain fetches and block writes.
+ * @param isTest True to print replay counters.
+ * @param options Only cacheBytes is used.
+ * @return Start points of the roads that were skipped.
+ * @throws std::runtime_error If @p in is not a valid plan file.
+ */
+std::vector<mcpp::Coordinate>
+replayPlans(std::istream& in,
+            ConnectionPool& pool,
+            bool isTest,
+            const ConnectOptions& options = ConnectOptions());
 
 /* ------------------------------------------
  * ------------ Helper functions ------------
  * ------------------------------------------ */
 
+/**
+ * @brief A committed plan waiting to be built, with the terrain it was planned on.
+ */
+struct BuildJob {
+    SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> plan;
+    mcpp::HeightMap heightMap;
+    SurfaceSlab surface;
+    int cost = 0;
+};
+
+/**
+ * @brief Finds the route of one link, widening its window if allowed.
+ *
+ * @param world Terrain source.
+ * @param path Link to route.
+ * @param plots Plot obstacles to avoid during pathfinding.
+ * @param border Border of the village.
+ * @param occupied Cells used by earlier paths.
+ * @param options Window policy and fetch mode.
+ * @param runReport Accumulates the window counters and fetch/search times.
+ * @return The plan (empty if none) and the terrain it was planned on.
+ */
+BuildJob planLink(WorldModel& world,
+                  const Path& path,
+                  const std::vector<Plot>& plots,
+                  const Plot& border,
+                  const OccupancyGrid& occupied,
+                  const ConnectOptions& options,
+                  ConnectReport& runReport);
+
+/**
+ * @brief Fetches the terrain under a planned route, current with our writes.
+ * @param world Terrain source.
+ * @param plan Route to fetch; must not be empty.
+ * @return Job holding @p plan and the terrain of its bounding rectangle.
+ */
+BuildJob fetchPlanTerrain(WorldModel& world,
+                          ConstSpan<mcpp::Coordinate2D> plan);
+
+/**
+ * @brief Hashes the terrain a road is planned or replayed on.
+ *
+ * Covers the height and top block of every cell of @p plan that no earlier
+ * road uses. Earlier roads change the cells they run along, so leaving
+ * those out gives the same fingerprint whether or not the earlier roads
+ * were already built when the terrain was read (as in pipelined mode).
+ * @p planned must hold every cell of those roads, including the ends that
+ * registerPath leaves free for crossings.
+ *
+ * @param plan Route of the road.
+ * @param heightMap Terrain covering @p plan.
+ * @param surface Blocks around the surface of @p heightMap.
+ * @param planned All cells of the earlier roads.
+ * @return 64-bit FNV-1a hash.
+ */
+uint64_t planFingerprint(ConstSpan<mcpp::Coordinate2D> plan,
+                         const mcpp::HeightMap& heightMap,
+                         const SurfaceSlab& surface,
+                         const OccupancyGrid& planned);
+
+/**
+ * @brief Fetches the terrain of a search window.
+ * @param world Terrain source.
+ * @param first One corner.
+ * @param second Opposite corner.
+ * @param surfaceOnly True to fetch only the blocks around the surface.
+ * @return Job with an empty plan and the window's terrain.
+ */
+BuildJob fetchWindow(WorldModel& world,
+                     const mcpp::Coordinate& first,
+                     const mcpp::Coordinate& second,
+                     bool surfaceOnly);
+
+/**
+ * @brief Computes the window around a link.
+ * @param path Link the window is for.
+ * @param margin Margin along x and z.
+ * @param yMargin Margin along y.
+ * @param first Receives one corner.
+ * @param second Receives the opposite corner.
+ */
+void searchWindow(const Path& path,
+                  int margin,
+                  int yMargin,
+                  mcpp::Coordinate& first,
+                  mcpp::Coordinate& second);
+
+/**
+ * @brief Bytes a direct download of a window's heights and blocks takes.
+ * @param first One corner.
+ * @param second Opposite corner.
+ * @return Size of the height map plus the block cuboid.
+ */
+long long windowBytes(const mcpp::Coordinate& first,
+                      const mcpp::Coordinate& second);
+
+/**
+ * @brief Builder stage of the pipelined mode.
+ *
+ * Builds queued jobs in order until the queue is closed and drained. On an
+ * exception, records it in @p failure and closes the queue so the planner
+ * stops too.
+ *
+ * @param jobs Queue fed by the planner.
+ * @param world Backend the block writes go to.
+ * @param written Accumulates the write counters of every build.
+ * @param buildSeconds Accumulates the time spent building.
+ * @param failure Receives the first exception thrown while building.
+ */
+void runBuilder(BoundedQueue<BuildJob>& jobs,
+                WorldBackend& world,
+                BlockWriteBuffer::Stats& written,
+                double& buildSeconds,
+                std::exception_ptr& failure);
+
+/**
+ * @brief Loads the terrain every link search could read into @p world.
+ *
+ * Covers the border rectangle widened by @p margin, over the y range of all
+ * points widened by @p margin.
+ *
+ * @param world Cache to fill.
+ * @param border Border of the village.
+ * @param connected Points already linked.
+ * @param unconnected Points still unlinked.
+ * @param margin Widest window margin of any link (see prefetchMargin).
+ * @param surfaceOnly True to load only the blocks around the surface.
+ */
+void prefetchBorder(WorldModel& world,
+                    const Plot& border,
+                    const std::vector<mcpp::Coordinate>& connected,
+                    const std::vector<mcpp::Coordinate>& unconnected,
+                    int margin,
+                    bool surfaceOnly);
+
+/**
+ * @brief Returns the widest margin the first search of any link can use.
+ *
+ * A point is never linked farther than to its nearest point connected now,
+ * since connected points are only ever added, so the bound is taken over
+ * those distances. The y range always uses the fixed margin, so it is
+ * included even in adaptive mode.
+ *
+ * @param connected Points already linked.
+ * @param unconnected Points still unlinked.
+ * @param options Window settings of the run.
+ * @return Margin for prefetchBorder.
+ */
+int prefetchMargin(const std::vector<mcpp::Coordinate>& connected,
+                   const std::vector<mcpp::Coordinate>& unconnected,
+                   const ConnectOptions& options);
+
+/**
+ * @brief Adds the counters of one build to a running total.
+ * @param total Running total (modified).
+ * @param build Counters of one buildPath call.
+ */
+void addWriteStats(BlockWriteBuffer::Stats& total,
+                   const BlockWriteBuffer::Stats& build);
+
 /**
  * @brief Find the closest pair between connected and unconnected sets.
  *
  * Uses Manhattan distance to find the smallest pair of points where
  * one belongs to the connected set and the other to the unconnected set.
+ * Scans every pair; connectPoints gets the same links from LinkSelector.
  *
  * @param connected Already connected set of points.
  * @param unconnected Unconnected points to be linked.
@@ -82,16 +494,23 @@ void increaseMargin(mcpp::Coordinate& first,
  * @param plan Sequence of 2D points from start -> end.
  * @param path Path context (contains start and end).
  */
-void printRoute(const Vector<mcpp::Coordinate2D>& plan,
+void printRoute(ConstSpan<mcpp::Coordinate2D> plan,
                 const Path& path);
 
 /**
  * @brief Marks coordinates from the path as occupied to avoid overlap.
  * 
  * @param plan The path coordinates to register.
- * @param occupiedCoords Map tracking already used coordinates.
+ * @param occupiedCoords Grid tracking already used coordinates.
+ */
+void registerPath(ConstSpan<mcpp::Coordinate2D> plan,
+                  OccupancyGrid& occupiedCoords);
+
+/**
+ * @brief Wall-clock seconds elapsed since @p start.
+ * @param start Time taken with std::chrono::steady_clock::now().
+ * @return Elapsed seconds.
  */
-void registerPath(const Vector<mcpp::Coordinate2D>& plan,
-                  Map<mcpp::Coordinate2D, bool>& occupiedCoords);
+double secondsSince(const std::chrono::steady_clock::time_point& start);
 
 #endif
\ No newline at end of file
@@ -6,26 +6,38 @@
 #include <math.h>
 
 #include "Map.h"
+#include "Trace.h"
 
 
 
 
-Vector<mcpp::Coordinate2D> 
+SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> 
 findPath(const Path& path,
-         const Vector<Plot>& plots,
+         ConstSpan<Plot> plots,
          const Plot& border,
          const mcpp::HeightMap& heightMap,
-         const mcpp::Chunk& chunk,
-         const Map<mcpp::Coordinate2D,
-         bool>& occupied) {
+         const SurfaceSlab& surface,
+         const OccupancyGrid& occupied,
+         SearchReport* report) {
 
-    PriorityQueue<Cell> toExplore{};
+    TRACE_SCOPE("findPath");
 
-    Map<mcpp::Coordinate2D, int> gScore{};
-    Map<mcpp::Coordinate2D, mcpp::Coordinate2D> parent{};
+    // every container of this search draws from one arena,
+    // which is released in one go when the search returns
+    Arena arena{};
+
+    OpenSet toExplore{ArenaAllocator<Cell>(&arena)};
+
+    ScoreMap gScore(8, ScoreMap::allocator_type(&arena));
+    ParentMap parent(8, ParentMap::allocator_type(&arena));
 
     mcpp::Coordinate2D endCoord2D = path.end;
 
+    // cells outside the height map are rejected anyway, so only that
+    // rectangle of the occupancy grid is needed
+    OccupancyGrid::Window occupiedWindow = occupied.extract(
+        heightMap.base_pt(), int(heightMap.x_len()), int(heightMap.z_len()));
+
     Cell curr(path.start);
     curr.f = heuristic(path.start, path.end);
     gScore[path.start] = 0;
@@ -44,12 +56,12 @@ findPath(const Path& path,
 
         else {
 
-            bool gScoreHasCurr = gScore.contains(curr.coord);
+            const int* bestG = gScore.find(curr.coord);
 
             //skipping stale entries
             bool isStale = false;
-            if (gScoreHasCurr) {
-                int fBestNow = gScore[curr.coord] + heuristic(curr.coord, path.end);
+            if (bestG != nullptr) {
+                int fBestNow = *bestG + heuristic(curr.coord, path.end);
 
                 
                 if (curr.f > fBestNow) {
@@ -59,8 +71,12 @@ findPath(const Path& path,
             
             if (!isStale) {
 
-                processNeighbors(curr, path, plots, border, heightMap, chunk,
-                     gScore, parent, toExplore, occupied);
+                processNeighbors(curr, path, plots, border, heightMap, surface,
+                     gScore, parent, toExplore, occupiedWindow, report);
+
+                if (report != nullptr) {
+                    ++report->expanded;
+                }
 
             }
 
@@ -68,7 +84,7 @@ findPath(const Path& path,
 
     }
 
-    Vector<mcpp::Coordinate2D> result;
+    SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> result;
 
     if (!foundCell) {
         std::cout << "No path found: " <<
@@ -76,6 +92,10 @@ findPath(const Path& path,
     }
     else {
         result = backtrack(curr, parent, path);
+
+        if (report != nullptr) {
+            report->cost = *gScore.find(curr.coord);
+        }
     }
 
     return result;
@@ -84,35 +104,36 @@ findPath(const Path& path,
 
 void processNeighbors(Cell& curr,
                       const Path& path,
-                      const Vector<Plot>& plots,
+                      ConstSpan<Plot> plots,
                       const Plot& border,
                       const mcpp::HeightMap& heightMap,
-                      const mcpp::Chunk& chunk,
-                      Map<mcpp::Coordinate2D, int>& gScore,
-                      Map<mcpp::Coordinate2D, mcpp::Coordinate2D>& parent,
-                      PriorityQueue<Cell>& toExplore,
-                      const Map<mcpp::Coordinate2D, 
-                      bool>& occupied) {
-
-    bool gScoreHasCurr = gScore.contains(curr.coord);
-    int gScoreCurr = gScore[curr.coord];
+                      const SurfaceSlab& surface,
+                      ScoreMap& gScore,
+                      ParentMap& parent,
+                      OpenSet& toExplore,
+                      const OccupancyGrid::Window& occupied,
+                      SearchReport* report) {
+
+    const int* gScoreCurr = gScore.find(curr.coord);
+    int currG = (gScoreCurr != nullptr) ? *gScoreCurr : INT_MAX;
     
-    Vector<Cell> neighbors = curr.getNeighbors();
+    SmallVector<Cell, 4> neighbors = curr.getNeighbors();
     
     for (Cell neighbor : neighbors) {
 
         if (isValidCell(neighbor, curr, plots, border, heightMap, occupied)) {
 
-            int step = calculateCost(neighbor, curr, heightMap, chunk);
+            int step = calculateCost(neighbor, curr, heightMap, surface);
 
-            int currG = gScoreHasCurr ? gScoreCurr : INT_MAX;
             int tentativeG = (currG == INT_MAX) ? INT_MAX : currG + step;
-            int bestKnown  = gScore.contains(neighbor.coord) ? gScore[neighbor.coord] : INT_MAX;
+
+            // one probe: finds the neighbor's score or reserves its slot
+            int& bestKnown = *gScore.try_emplace(neighbor.coord, INT_MAX).first;
 
             // better path found
             if (tentativeG < bestKnown) {
-                gScore[neighbor.coord] = tentativeG;
-                parent[neighbor.coord] = curr.coord;
+                bestKnown = tentativeG;
+                parent.insert_or_assign(neighbor.coord, curr.coord);
 
                 neighbor.h = heuristic(neighbor.coord, path.end);
                 neighbor.f = tentativeG + neighbor.h;
@@ -120,6 +141,18 @@ void processNeighbors(Cell& curr,
                 toExplore.insert(neighbor);
             }
         }
+
+        // the border allows this cell, only the fetched window does not
+        else if (report != nullptr && !report->hitEdge &&
+                 isInBorder(neighbor.coord, border)) {
+            mcpp::Coordinate base = heightMap.base_pt();
+            int x = neighbor.coord.x - base.x;
+            int z = neighbor.coord.z - base.z;
+
+            if (x < 0 || z < 0 || x >= int(heightMap.x_len()) || z >= int(heightMap.z_len())) {
+                report->hitEdge = true;
+            }
+        }
         
     }
 }
@@ -128,15 +161,14 @@ void processNeighbors(Cell& curr,
 
 bool isValidCell(const Cell& cell,
                  const Cell& parent,
-                 const Vector<Plot>& plots,
+                 ConstSpan<Plot> plots,
                  const Plot& border,
                  const mcpp::HeightMap& heightMap,
-                 const Map<mcpp::Coordinate2D, 
-                 bool>& occupied) {
+                 const OccupancyGrid::Window& occupied) {
 
     bool isViolating = false;
 
-    if (occupied.contains(cell.coord)) {
+    if (occupied.test(cell.coord)) {
         isViolating = true;
     }
 
@@ -150,7 +182,7 @@ bool isValidCell(const Cell& cell,
     if (!isViolating) {
         
         for (size_t i = 0; !isViolating && i < plots.getSize(); ++i) {
-            Plot plot = plots[i];
+            const Plot& plot = plots[i];
 
             if (isInPlot(cell.coord, plot)) {
                 isViolating = true;
@@ -207,7 +239,7 @@ bool isInPlot(mcpp::Coordinate2D coord,
 int calculateCost(const Cell& cell,
                   const Cell& parent, 
                   const mcpp::HeightMap& heightMap, 
-                  const mcpp::Chunk& chunk) {
+                  const SurfaceSlab& surface) {
 
     const int DEFAULT_STEP = 1;
     const int HEIGHT_PENALTY = 2;
@@ -229,7 +261,7 @@ int calculateCost(const Cell& cell,
 
         mcpp::Coordinate cellCoord(cell.coord.x, cellHeight, cell.coord.z);
 
-        mcpp::BlockType cellBlock = chunk.get_worldspace(cellCoord);
+        mcpp::BlockType cellBlock = surface.get_worldspace(cellCoord);
 
         if (cellBlock == mcpp::Blocks::STILL_WATER ||
                  cellBlock == mcpp::Blocks::FLOWING_WATER) {
@@ -245,30 +277,44 @@ int calculateCost(const Cell& cell,
 }
 
 
-Vector<mcpp::Coordinate2D> 
+SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> 
 backtrack(Cell& lastCellFound,
-          Map<mcpp::Coordinate2D, mcpp::Coordinate2D>& parent,
+          ParentMap& parent,
           const Path& path) {
 
-    Vector<mcpp::Coordinate2D> result;
+    SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> result;
     mcpp::Coordinate2D curr = lastCellFound.coord;
 
 
-    while (curr != path.start) {
+    bool brokenChain = false;
+    while (!brokenChain && curr != path.start) {
         result.push_back(curr);
-        curr = parent[curr];
-    }
 
-    result.push_back(path.start);
+        // lookups must not insert; a missing parent means no route
+        const mcpp::Coordinate2D* prev = parent.find(curr);
+        if (prev == nullptr) {
+            brokenChain = true;
+        }
+        else {
+            curr = *prev;
+        }
+    }
 
-    // reverse order to make it: start->goal
-    size_t resultSize = result.getSize();
-    for (size_t i = 0; i < resultSize / 2; ++i) {
-        auto temp = result[i];
-        result[i] = result[resultSize - 1 - i];
-        result[resultSize - 1 - i] = temp;
+    if (brokenChain) {
+        result.clear();
     }
-    
+    else {
+        result.push_back(path.start);
+
+        // reverse order to make it: start->goal
+        size_t resultSize = result.getSize();
+        for (size_t i = 0; i < resultSize / 2; ++i) {
+            auto temp = result[i];
+            result[i] = result[resultSize - 1 - i];
+            result[resultSize - 1 - i] = temp;
+        }
+    }
+
 
     return result;
 }
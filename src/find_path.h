@@ -4,13 +4,44 @@
 #include <mcpp/mcpp.h>
 
 #include "Vector.h"
+#include "SmallVector.h"
+#include "routes.h"
+#include "Span.h"
 #include "PriorityQueue.h"
 #include "Cell.h"
 #include "Map.h"
+#include "FlatMap.h"
+#include "Hash.h"
+#include "OccupancyGrid.h"
+#include "SurfaceSlab.h"
+#include "Arena.h"
+#include "ArenaAllocator.h"
 
 #include "../paths.h"
 #include "../plots.h"
 
+/**
+ * @brief Per-search containers. They all allocate from the Arena of the
+ * search that owns them, which is released in one go when it finishes.
+ */
+using ScoreMap = FlatMap<mcpp::Coordinate2D, int, CoordHash,
+    ArenaAllocator<std::pair<const mcpp::Coordinate2D, int>>>;
+using ParentMap = FlatMap<mcpp::Coordinate2D, mcpp::Coordinate2D, CoordHash,
+    ArenaAllocator<std::pair<const mcpp::Coordinate2D, mcpp::Coordinate2D>>>;
+using OpenSet = PriorityQueue<Cell, ArenaAllocator<Cell>>;
+
+/**
+ * @brief What a search ran into, for callers that size its window.
+ */
+struct SearchReport {
+    /** @brief A cell inside the border was rejected only for lying outside the height map. */
+    bool hitEdge = false;
+    /** @brief Number of cells expanded. */
+    size_t expanded = 0;
+    /** @brief Cost of the route found, 0 if none. */
+    int cost = 0;
+};
+
 /**
  * @brief Compute a path using A* on a heightmap while avoiding plots.
  *
@@ -19,21 +50,24 @@
  * Returns start -> end coordinates if found; otherwise an empty vector.
  *
  * @param path Path descriptor (uses start/end; not modified).
- * @param plots Plots to avoid (obstacles).
+ * @param plots Plots to avoid (obstacles); any contiguous container converts.
  * @param border Border of the village.
  * @param heightMap World height data for slope/validity checks.
- * @param chunk Block data to detect water and surface blocks.
- * @param occupied Map tracking used path coordinates to prevent overlaps.
+ * @param surface Blocks around the surface, to detect water.
+ * @param occupied Cells used by earlier paths; the part under @p heightMap
+ *   is copied into a dense window once per search.
+ * @param report Optional; receives whether the search reached the edge of
+ *   @p heightMap, how many cells it expanded and the cost of the route.
  * @return 2D coordinates from start to goal, or empty if none.
  */
-Vector<mcpp::Coordinate2D>
+SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP>
 findPath(const Path& path,
-         const Vector<Plot>& plots,
+         ConstSpan<Plot> plots,
          const Plot& border,
          const mcpp::HeightMap& heightMap,
-         const mcpp::Chunk& chunk,
-         const Map<mcpp::Coordinate2D, 
-         bool>& occupied);
+         const SurfaceSlab& surface,
+         const OccupancyGrid& occupied,
+         SearchReport* report = nullptr);
 
 /**
  * @brief Expand @p curr's neighbors and update A* scores.
@@ -46,23 +80,24 @@ findPath(const Path& path,
  * @param plots Plots to avoid when validating cells.
  * @param border Border of the village.
  * @param heightMap Terrain data for slope checks.
- * @param chunk Block data for water/surface checks.
+ * @param surface Blocks around the surface, for water checks.
  * @param gScore Map of g-costs (cost-from-start) by coordinate.
  * @param parent Came-from map: child coord -> parent coord.
  * @param toExplore Open set (min-heap) used by A*.
- * @param occupied Map tracking used path coordinates to prevent overlaps.
+ * @param occupied Dense occupancy window of the search region.
+ * @param report Optional; set when a neighbor falls off @p heightMap.
  */
 void processNeighbors(Cell& curr,
                       const Path& path,
-                      const Vector<Plot>& plots,
+                      ConstSpan<Plot> plots,
                       const Plot& border,
                       const mcpp::HeightMap& heightMap,
-                      const mcpp::Chunk& chunk,
-                      Map<mcpp::Coordinate2D, int>& gScore,
-                      Map<mcpp::Coordinate2D, mcpp::Coordinate2D>& parent,
-                      PriorityQueue<Cell>& toExplore,
-                      const Map<mcpp::Coordinate2D, 
-                      bool>& occupied);
+                      const SurfaceSlab& surface,
+                      ScoreMap& gScore,
+                      ParentMap& parent,
+                      OpenSet& toExplore,
+                      const OccupancyGrid::Window& occupied,
+                      SearchReport* report = nullptr);
 
 /* ------------------------------------------
  * ------------ Helper functions ------------
@@ -79,16 +114,15 @@ void processNeighbors(Cell& curr,
  * @param plots Areas to avoid (blocked).
  * @param border Border of the village.
  * @param heightMap Height lookup for slope and bounds.
- * @param occupied Map tracking used path coordinates to prevent overlaps.
+ * @param occupied Dense occupancy window of the search region.
  * @return true if traversable; false otherwise.
  */
 bool isValidCell(const Cell& cell,
                  const Cell& parent,
-                 const Vector<Plot>& plots,
+                 ConstSpan<Plot> plots,
                  const Plot& border,
                  const mcpp::HeightMap& heightMap,
-                 const Map<mcpp::Coordinate2D, 
-                 bool>& occupied);
+                 const OccupancyGrid::Window& occupied);
 
 /**
  * @brief Checks if a coordinate lies strictly inside the village border area.
@@ -128,27 +162,28 @@ bool isInPlot(mcpp::Coordinate2D coord,
  * @param cell Destination cell.
  * @param parent Source cell.
  * @param heightMap Height data for slope calculation.
- * @param chunk Block data for water detection.
+ * @param surface Blocks around the surface, for water detection.
  * @return Non-negative movement cost; large value for violations.
  */
 int calculateCost(const Cell& cell,
                   const Cell& parent,
                   const mcpp::HeightMap& heightMap,
-                  const mcpp::Chunk& chunk);
+                  const SurfaceSlab& surface);
 
 /**
  * @brief Reconstruct path by following @p parent from goal to start.
  *
- * Produces a start->goal ordered sequence.
+ * Produces a start->goal ordered sequence. Never inserts into @p parent;
+ * an incomplete parent chain yields an empty route.
  *
  * @param foundLastCell Goal cell reached by the search.
  * @param parent Map from child coord -> parent coord.
  * @param path Path context (provides start).
  * @return Coordinates from start to goal (inclusive).
  */
-Vector<mcpp::Coordinate2D>
+SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP>
 backtrack(Cell& foundLastCell,
-          Map<mcpp::Coordinate2D, mcpp::Coordinate2D>& parent,
+          ParentMap& parent,
           const Path& path);
 
 /**
@@ -161,21 +196,4 @@ int heuristic(const mcpp::Coordinate2D& a,
               const mcpp::Coordinate2D& b);
 
 
-// Simple hash for Coord2D in Map
-namespace std {
-    template<>
-    struct hash<mcpp::Coordinate2D> {
-
-        size_t operator()(const mcpp::Coordinate2D& c) const noexcept {
-
-            uint64_t x = static_cast<uint32_t>(c.x);
-            uint64_t z = static_cast<uint32_t>(c.z);
-            uint64_t h = x * 0x9E3779B185EBCA87ull ^
-                (z + 0x9E3779B185EBCA87ull + (x<<6) + (x>>2));
-                
-            return static_cast<size_t>(h);
-        }
-    };
-}
-
 #endif
\ No newline at end of file
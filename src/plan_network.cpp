@@ -0,0 +1,366 @@
+#include "plan_network.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "PriorityQueue.h"
+#include "Trace.h"
+
+
+bool RegionStep::operator<(const RegionStep& other) const {
+    return dist < other.dist || (dist == other.dist && cell < other.cell);
+}
+
+
+bool RegionStep::operator>(const RegionStep& other) const {
+    return other < *this;
+}
+
+
+bool TerminalPair::operator==(const TerminalPair& other) const {
+    return low == other.low && high == other.high;
+}
+
+
+size_t TerminalPairHash::operator()(const TerminalPair& pair) const noexcept {
+
+    uint64_t packed = (uint64_t(uint32_t(pair.low)) << 32) | uint32_t(pair.high);
+
+    return static_cast<size_t>(mix64(packed));
+}
+
+
+std::vector<NetworkLink> planNetwork(const std::vector<mcpp::Coordinate>& connected,
+                                     const std::vector<mcpp::Coordinate>& unconnected,
+                                     ConstSpan<Plot> plots,
+                                     const Plot& border,
+                                     const mcpp::HeightMap& heightMap,
+                                     const SurfaceSlab& surface,
+                                     const OccupancyGrid& occupied,
+                                     bool houseToWaypoint) {
+
+    TRACE_SCOPE("planNetwork");
+
+    // terminals [0, connectedCount) are connected, the rest are not
+    Vector<mcpp::Coordinate> terminals{};
+    for (const mcpp::Coordinate& point : connected) {
+        terminals.push_back(point);
+    }
+    for (const mcpp::Coordinate& point : unconnected) {
+        terminals.push_back(point);
+    }
+    int connectedCount = int(connected.size());
+    int terminalCount = int(terminals.getSize());
+
+    OccupancyGrid::Window occupiedWindow = occupied.extract(
+        heightMap.base_pt(), int(heightMap.x_len()), int(heightMap.z_len()));
+
+    std::vector<NetworkLink> links{};
+
+    if (houseToWaypoint) {
+        TerminalRegions regions = growRegions(terminals, connectedCount, plots, border,
+                                              heightMap, surface, occupiedWindow);
+
+        // a house takes the cheapest route to whichever point owns its cell
+        Vector<char> isTaken(regions.dist.getSize());
+
+        for (int i = connectedCount; i < terminalCount; ++i) {
+            int x = terminals[i].x - regions.base.x;
+            int z = terminals[i].z - regions.base.z;
+            int cell = x * regions.zLen + z;
+
+            bool isReached = x >= 0 && z >= 0 && x < regions.xLen && z < regions.zLen &&
+                             regions.owner[cell] != -1 && regions.dist[cell] > 0 &&
+                             !isTaken[cell];
+
+            if (isReached) {
+                isTaken[cell] = 1;
+
+                NetworkLink link{};
+                link.path.start = terminals[i];
+                link.path.end = terminals[regions.owner[cell]];
+                link.cost = regions.dist[cell];
+
+                for (const mcpp::Coordinate2D& coord : traceToTerminal(regions, cell)) {
+                    link.plan.push_back(coord);
+                }
+
+                links.push_back(link);
+            }
+        }
+    }
+    else {
+        links = planTree(terminals, connectedCount, plots, border,
+                         heightMap, surface, occupiedWindow);
+    }
+
+    return links;
+}
+
+
+std::vector<NetworkLink> planTree(ConstSpan<mcpp::Coordinate> terminals,
+                                  int connectedCount,
+                                  ConstSpan<Plot> plots,
+                                  const Plot& border,
+                                  const mcpp::HeightMap& heightMap,
+                                  const SurfaceSlab& surface,
+                                  const OccupancyGrid::Window& occupied) {
+
+    int terminalCount = int(terminals.getSize());
+
+    TerminalRegions regions = growRegions(terminals, terminals.getSize(), plots, border,
+                                          heightMap, surface, occupied);
+
+    FlatMap<TerminalPair, RegionBridge, TerminalPairHash> bridges =
+        findBridges(regions, plots, border, heightMap, surface, occupied);
+
+    // Kruskal over the bridges, cheapest first, ties by terminal pair;
+    // bridges between two connected points add nothing
+    std::vector<std::pair<TerminalPair, RegionBridge>> candidates{};
+    for (const auto& entry : bridges) {
+        if (entry.key.high >= connectedCount) {
+            candidates.push_back(std::make_pair(entry.key, entry.value));
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const std::pair<TerminalPair, RegionBridge>& a,
+           const std::pair<TerminalPair, RegionBridge>& b) {
+            bool isLess = false;
+            if (a.second.cost != b.second.cost) {
+                isLess = a.second.cost < b.second.cost;
+            }
+            else if (a.first.low != b.first.low) {
+                isLess = a.first.low < b.first.low;
+            }
+            else {
+                isLess = a.first.high < b.first.high;
+            }
+            return isLess;
+        });
+
+    // the connected points start out as one component
+    Vector<int> sets(terminalCount);
+    for (int i = 0; i < terminalCount; ++i) {
+        sets[i] = (i < connectedCount) ? 0 : i;
+    }
+
+    // tree edges per terminal, as indices into candidates
+    std::vector<std::vector<int>> treeEdges(terminalCount);
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        int first = findSet(sets, candidates[i].first.low);
+        int second = findSet(sets, candidates[i].first.high);
+
+        if (first != second) {
+            sets[second] = first;
+            treeEdges[candidates[i].first.low].push_back(int(i));
+            treeEdges[candidates[i].first.high].push_back(int(i));
+        }
+    }
+
+    // walk the tree outward from the connected points, so each link
+    // attaches one new point to the part already joined
+    std::vector<NetworkLink> links{};
+    Vector<char> isJoined(terminalCount);
+    std::vector<int> frontier{};
+
+    for (int i = 0; i < connectedCount; ++i) {
+        isJoined[i] = 1;
+        frontier.push_back(i);
+    }
+
+    for (size_t next = 0; next < frontier.size(); ++next) {
+        int from = frontier[next];
+
+        for (int edge : treeEdges[from]) {
+            const TerminalPair& pair = candidates[edge].first;
+            const RegionBridge& bridge = candidates[edge].second;
+            int to = (pair.low == from) ? pair.high : pair.low;
+
+            if (!isJoined[to]) {
+                isJoined[to] = 1;
+                frontier.push_back(to);
+
+                // the new point's half, reversed, then the joined point's half
+                int newSide = (pair.low == to) ? bridge.first : bridge.second;
+                int oldSide = (pair.low == to) ? bridge.second : bridge.first;
+
+                NetworkLink link{};
+                link.path.start = terminals[to];
+                link.path.end = terminals[from];
+                link.cost = bridge.cost;
+
+                Vector<mcpp::Coordinate2D> toNew = traceToTerminal(regions, newSide);
+                for (size_t k = toNew.getSize(); k > 0; --k) {
+                    link.plan.push_back(toNew[k - 1]);
+                }
+                for (const mcpp::Coordinate2D& coord : traceToTerminal(regions, oldSide)) {
+                    link.plan.push_back(coord);
+                }
+
+                links.push_back(link);
+            }
+        }
+    }
+
+    return links;
+}
+
+
+TerminalRegions growRegions(ConstSpan<mcpp::Coordinate> terminals,
+                            size_t sourceCount,
+                            ConstSpan<Plot> plots,
+                            const Plot& border,
+                            const mcpp::HeightMap& heightMap,
+                            const SurfaceSlab& surface,
+                            const OccupancyGrid::Window& occupied) {
+
+    TerminalRegions regions{};
+    regions.base = heightMap.base_pt();
+    regions.xLen = int(heightMap.x_len());
+    regions.zLen = int(heightMap.z_len());
+
+    size_t cellCount = size_t(regions.xLen) * regions.zLen;
+    regions.dist = Vector<int>(cellCount);
+    regions.owner = Vector<int>(cellCount);
+    regions.parent = Vector<int>(cellCount);
+
+    for (size_t i = 0; i < cellCount; ++i) {
+        regions.dist[i] = INT_MAX;
+        regions.owner[i] = -1;
+        regions.parent[i] = -1;
+    }
+
+    PriorityQueue<RegionStep> toExplore{};
+
+    for (size_t i = 0; i < sourceCount; ++i) {
+        int x = terminals[i].x - regions.base.x;
+        int z = terminals[i].z - regions.base.z;
+
+        bool isInside = x >= 0 && z >= 0 && x < regions.xLen && z < regions.zLen;
+
+        if (isInside && regions.owner[x * regions.zLen + z] == -1) {
+            int cell = x * regions.zLen + z;
+
+            regions.dist[cell] = 0;
+            regions.owner[cell] = int(i);
+            toExplore.insert(RegionStep{0, cell});
+        }
+    }
+
+    while (!toExplore.isEmpty()) {
+        RegionStep step = toExplore.pop();
+
+        // stale entries carry a distance already improved on
+        if (step.dist == regions.dist[step.cell]) {
+            Cell curr(mcpp::Coordinate2D(regions.base.x + step.cell / regions.zLen,
+                                         regions.base.z + step.cell % regions.zLen));
+
+            for (const Cell& neighbor : curr.getNeighbors()) {
+                int x = neighbor.coord.x - regions.base.x;
+                int z = neighbor.coord.z - regions.base.z;
+
+                if (isValidCell(neighbor, curr, plots, border, heightMap, occupied)) {
+                    int cell = x * regions.zLen + z;
+                    int tentative = step.dist +
+                        calculateCost(neighbor, curr, heightMap, surface);
+
+                    if (tentative < regions.dist[cell]) {
+                        regions.dist[cell] = tentative;
+                        regions.owner[cell] = regions.owner[step.cell];
+                        regions.parent[cell] = step.cell;
+                        toExplore.insert(RegionStep{tentative, cell});
+                    }
+                }
+            }
+        }
+    }
+
+    return regions;
+}
+
+
+FlatMap<TerminalPair, RegionBridge, TerminalPairHash>
+findBridges(const TerminalRegions& regions,
+            ConstSpan<Plot> plots,
+            const Plot& border,
+            const mcpp::HeightMap& heightMap,
+            const SurfaceSlab& surface,
+            const OccupancyGrid::Window& occupied) {
+
+    FlatMap<TerminalPair, RegionBridge, TerminalPairHash> bridges{};
+
+    for (int x = 0; x < regions.xLen; ++x) {
+        for (int z = 0; z < regions.zLen; ++z) {
+            int cell = x * regions.zLen + z;
+            int owner = regions.owner[cell];
+
+            if (owner != -1) {
+                Cell curr(mcpp::Coordinate2D(regions.base.x + x, regions.base.z + z));
+
+                for (const Cell& neighbor : curr.getNeighbors()) {
+                    // isValidCell rejects cells outside the height map first
+                    if (isValidCell(neighbor, curr, plots, border, heightMap, occupied)) {
+                        int other = (neighbor.coord.x - regions.base.x) * regions.zLen +
+                                    (neighbor.coord.z - regions.base.z);
+                        int otherOwner = regions.owner[other];
+
+                        if (otherOwner != -1 && otherOwner != owner) {
+                            int cost = regions.dist[cell] + regions.dist[other] +
+                                calculateCost(neighbor, curr, heightMap, surface);
+
+                            bool isFirstLow = owner < otherOwner;
+                            TerminalPair pair{std::min(owner, otherOwner),
+                                              std::max(owner, otherOwner)};
+                            RegionBridge bridge{cost, isFirstLow ? cell : other,
+                                                isFirstLow ? other : cell};
+
+                            std::pair<RegionBridge*, bool> slot =
+                                bridges.try_emplace(pair, bridge);
+                            if (!slot.second && cost < slot.first->cost) {
+                                *slot.first = bridge;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return bridges;
+}
+
+
+Vector<mcpp::Coordinate2D> traceToTerminal(const TerminalRegions& regions, int cell) {
+
+    Vector<mcpp::Coordinate2D> route{};
+
+    int curr = cell;
+    while (curr != -1) {
+        route.push_back(mcpp::Coordinate2D(regions.base.x + curr / regions.zLen,
+                                           regions.base.z + curr % regions.zLen));
+        curr = regions.parent[curr];
+    }
+
+    return route;
+}
+
+
+int findSet(Vector<int>& sets, int element) {
+
+    int root = element;
+    while (sets[root] != root) {
+        root = sets[root];
+    }
+
+    // point everything on the way straight at the root
+    int curr = element;
+    while (sets[curr] != root) {
+        int next = sets[curr];
+        sets[curr] = root;
+        curr = next;
+    }
+
+    return root;
+}
@@ -0,0 +1,202 @@
+#ifndef PLAN_NETWORK_H
+#define PLAN_NETWORK_H
+
+#include <vector>
+#include <mcpp/mcpp.h>
+
+#include "Vector.h"
+#include "SmallVector.h"
+#include "routes.h"
+#include "Span.h"
+#include "FlatMap.h"
+#include "Hash.h"
+#include "OccupancyGrid.h"
+#include "SurfaceSlab.h"
+#include "find_path.h"
+
+#include "../paths.h"
+#include "../plots.h"
+
+/**
+ * @brief One road of a planned network, ready to be built.
+ */
+struct NetworkLink {
+    Path path;
+    SmallVector<mcpp::Coordinate2D, ROUTE_INLINE_CAP> plan;
+    int cost;
+};
+
+/**
+ * @brief Result of the multi-source search: every reached cell belongs to
+ *   the terminal it is cheapest to reach from.
+ *
+ * Cells are indexed like the height map they cover (x * zLen + z).
+ */
+struct TerminalRegions {
+    mcpp::Coordinate2D base;
+    int xLen;
+    int zLen;
+    Vector<int> dist;
+    Vector<int> owner;
+    Vector<int> parent;
+};
+
+/**
+ * @brief Open-set entry of the multi-source search.
+ */
+struct RegionStep {
+    int dist = 0;
+    int cell = 0;
+
+    bool operator<(const RegionStep& other) const;
+    bool operator>(const RegionStep& other) const;
+};
+
+/**
+ * @brief Two terminals, by index, with the lower index first.
+ */
+struct TerminalPair {
+    int low = 0;
+    int high = 0;
+
+    bool operator==(const TerminalPair& other) const;
+};
+
+/**
+ * @brief Hash for TerminalPair, intended for FlatMap.
+ */
+struct TerminalPairHash {
+    size_t operator()(const TerminalPair& pair) const noexcept;
+};
+
+/**
+ * @brief Cheapest known crossing between the regions of two terminals.
+ */
+struct RegionBridge {
+    int cost;
+    int first;
+    int second;
+};
+
+/**
+ * @brief Plans the whole road network at once from true terrain costs.
+ *
+ * Grows the regions of all terminals together in one Dijkstra pass, using
+ * the same moves and step costs as findPath. Two terminals are candidate
+ * neighbors when their regions touch, which keeps the candidate pairs to
+ * the spatially close ones; the pair cost is the cheapest route through
+ * their common boundary. A minimum spanning tree over those pairs, with
+ * the connected points treated as one component, gives an approximate
+ * Steiner tree (Mehlhorn's construction).
+ *
+ * With @p houseToWaypoint, houses may not be linked through each other,
+ * so only the connected points are sources and every house reached gets
+ * the cheapest route to its nearest connected point (a shortest-path
+ * forest, which is optimal for that mode).
+ *
+ * Only the part of the tree reachable from the connected points is
+ * returned, ordered so that every link starts at a new point and ends on
+ * one already joined. Points left out are not reachable within the region
+ * (or share a cell with another point) and are for the caller to handle.
+ *
+ * @param connected Points already linked.
+ * @param unconnected Points to link.
+ * @param plots Plots to avoid.
+ * @param border Border of the village.
+ * @param heightMap Terrain of the planning region.
+ * @param surface Blocks around the surface of the planning region.
+ * @param occupied Cells that roads may not use.
+ * @param houseToWaypoint True to link unconnected points only to connected ones.
+ * @return Links in build order.
+ */
+std::vector<NetworkLink> planNetwork(const std::vector<mcpp::Coordinate>& connected,
+                                     const std::vector<mcpp::Coordinate>& unconnected,
+                                     ConstSpan<Plot> plots,
+                                     const Plot& border,
+                                     const mcpp::HeightMap& heightMap,
+                                     const SurfaceSlab& surface,
+                                     const OccupancyGrid& occupied,
+                                     bool houseToWaypoint);
+
+/* ------------------------------------------
+ * ------------ Helper functions ------------
+ * ------------------------------------------ */
+
+/**
+ * @brief Approximate Steiner tree over all terminals (Mehlhorn).
+ * @param terminals Connected points followed by unconnected points.
+ * @param connectedCount Number of leading connected terminals.
+ * @param plots Plots to avoid.
+ * @param border Border of the village.
+ * @param heightMap Terrain of the planning region.
+ * @param surface Blocks around the surface of the planning region.
+ * @param occupied Dense occupancy of the planning region.
+ * @return Tree links reachable from the connected terminals, in build order.
+ */
+std::vector<NetworkLink> planTree(ConstSpan<mcpp::Coordinate> terminals,
+                                  int connectedCount,
+                                  ConstSpan<Plot> plots,
+                                  const Plot& border,
+                                  const mcpp::HeightMap& heightMap,
+                                  const SurfaceSlab& surface,
+                                  const OccupancyGrid::Window& occupied);
+
+/**
+ * @brief Multi-source Dijkstra from terminals inside the height map.
+ *
+ * A terminal sharing its cell with an earlier one is not a source.
+ *
+ * @param terminals Connected points followed by unconnected points.
+ * @param sourceCount Number of leading terminals used as sources.
+ * @param plots Plots to avoid.
+ * @param border Border of the village.
+ * @param heightMap Terrain of the planning region.
+ * @param surface Blocks around the surface of the planning region.
+ * @param occupied Dense occupancy of the planning region.
+ * @return Distance, owning terminal and parent cell of every cell
+ *   (-1 where unreached).
+ */
+TerminalRegions growRegions(ConstSpan<mcpp::Coordinate> terminals,
+                            size_t sourceCount,
+                            ConstSpan<Plot> plots,
+                            const Plot& border,
+                            const mcpp::HeightMap& heightMap,
+                            const SurfaceSlab& surface,
+                            const OccupancyGrid::Window& occupied);
+
+/**
+ * @brief Finds the cheapest crossing between every pair of touching regions.
+ * @param regions Output of growRegions.
+ * @param plots Plots to avoid.
+ * @param border Border of the village.
+ * @param heightMap Terrain of the planning region.
+ * @param surface Blocks around the surface of the planning region.
+ * @param occupied Dense occupancy of the planning region.
+ * @return One entry per terminal pair; first and second are cells, with
+ *   the lower terminal owning first.
+ */
+FlatMap<TerminalPair, RegionBridge, TerminalPairHash>
+findBridges(const TerminalRegions& regions,
+            ConstSpan<Plot> plots,
+            const Plot& border,
+            const mcpp::HeightMap& heightMap,
+            const SurfaceSlab& surface,
+            const OccupancyGrid::Window& occupied);
+
+/**
+ * @brief Returns the route from a cell back to the terminal owning it.
+ * @param regions Output of growRegions.
+ * @param cell Cell index to start from.
+ * @return Coordinates from the cell to its terminal (inclusive).
+ */
+Vector<mcpp::Coordinate2D> traceToTerminal(const TerminalRegions& regions, int cell);
+
+/**
+ * @brief Root of a union-find set, compressing the path on the way.
+ * @param sets Parent of every element (modified).
+ * @param element Element to look up.
+ * @return Representative element of the set.
+ */
+int findSet(Vector<int>& sets, int element);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef ROUTES_H
+#define ROUTES_H
+
+#include <cstddef>
+
+/**
+ * @brief Number of route coordinates kept inline before spilling to the heap.
+ *
+ * Routes are held in SmallVector<..., ROUTE_INLINE_CAP>. Most house-to-road
+ * links are a few dozen cells long, so their routes never touch the
+ * allocator.
+ */
+constexpr size_t ROUTE_INLINE_CAP = 64;
+
+#endif